@@ -1,58 +1,250 @@
 #include "algorithms.h"
-#include <queue>
+#include "worker_pool.h"
+#include <functional>
 
 static const bool DEBUG_ENABLED = false;
 
+// splitmix64 finalizer, spreads the search parameters over the whole key
+static uint64_t mix64(uint64_t z) {
+    z += 0x9e3779b97f4a7c15ULL;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+uint64_t transposition_table::make_key(uint64_t board_hash, const tank* self, int lookahead, int stepsSinceBoardUpdate, search_mode mode) {
+    // The same board scores differently for each tank, depth and update age
+    uint64_t params = static_cast<uint64_t>(static_cast<uint16_t>(self->player_number))
+                    | static_cast<uint64_t>(static_cast<uint16_t>(self->tank_number)) << 16
+                    | static_cast<uint64_t>(static_cast<uint16_t>(lookahead)) << 32
+                    | static_cast<uint64_t>(static_cast<uint16_t>(stepsSinceBoardUpdate)) << 48;
+    // The board hash places every tank by its entity id; the searching tank's own cell goes in
+    // as well, so an entry is never read back for a tank standing elsewhere
+    uint64_t cell = static_cast<uint64_t>(static_cast<uint32_t>(self->get_x()))
+                  | static_cast<uint64_t>(static_cast<uint32_t>(self->get_y())) << 32;
+    uint64_t key = board_hash ^ mix64(params) ^ mix64(cell ^ mix64(params));
+    if (mode == search_mode::adversarial) {
+        key ^= mix64(~params); // Scores against enemy responses are a different quantity
+    }
+    return key ? key : 1;
+}
+
+bool transposition_table::probe(uint64_t key, double& score) const {
+    if (entries.empty()) return false;
+    const entry& e = entries[key & (entries.size() - 1)];
+    if (e.key != key) return false;
+    score = e.score;
+    return true;
+}
+
+void transposition_table::store(uint64_t key, double score) {
+    if (entries.empty()) entries.resize(size_t(1) << TT_SIZE_LOG2);
+    entry& e = entries[key & (entries.size() - 1)];
+    e.key = key;
+    e.score = score;
+}
+
+void distance_fields::sync(const game_board* board) {
+    if (board->static_version == version) {
+        return;
+    }
+    version = board->static_version;
+
+    std::vector<uint8_t> layer(board->cells.size());
+    for (int y = 0; y < board->m; y++) {
+        for (int x = 0; x < board->n; x++) {
+            layer[board->index(x, y)] = board->has_wall(x, y) || board->has_mine(x, y);
+        }
+    }
+    if (n == board->n && m == board->m && layer == blocked) {
+        return; // Same static layer, the fields are still valid
+    }
+    n = board->n;
+    m = board->m;
+    blocked = std::move(layer);
+    fields.clear();
+}
+
+const std::vector<int>& distance_fields::field_from(int x, int y) {
+    int source = y * n + x;
+    auto it = fields.find(source);
+    if (it != fields.end()) {
+        return it->second;
+    }
+
+    // Breadth-first over 8 directions with wrap-around; blocked cells (walls and mines) can be
+    // reached, the other tank may stand on one, but not crossed. Distances are exact, cells never
+    // reached stay UNREACHED
+    std::vector<int> dist(n * m, UNREACHED);
+    std::vector<int> frontier = {source};
+    dist[source] = 0;
+    for (size_t head = 0; head < frontier.size(); head++) {
+        int current = frontier[head];
+        int cx = current % n;
+        int cy = current / n;
+        for (int dx = -1; dx <= 1; ++dx) {
+            for (int dy = -1; dy <= 1; ++dy) {
+                if (dx == 0 && dy == 0) {
+                    continue;
+                }
+                int next = ((cy + dy + m) % m) * n + (cx + dx + n) % n;
+                if (dist[next] != UNREACHED) {
+                    continue;
+                }
+                dist[next] = dist[current] + 1;
+                if (!blocked[next]) {
+                    frontier.push_back(next);
+                }
+            }
+        }
+    }
+    return fields.emplace(source, std::move(dist)).first->second;
+}
+
+int distance_fields::distance(const game_board* board, const Vector2D& from, const Vector2D& to) {
+    if (n != board->n || m != board->m) {
+        sync(board);
+    }
+    int d = field_from(to.x, to.y)[from.y * n + from.x];
+    return d == UNREACHED ? NO_PATH : d;
+}
+
+size_t shell_danger_fields::field_key_hash::operator()(const field_key& k) const {
+    uint64_t packed = static_cast<uint64_t>(static_cast<uint32_t>(k.index))
+                    | static_cast<uint64_t>(k.dir) << 32;
+    return static_cast<size_t>(mix64(k.static_version ^ mix64(packed)));
+}
+
+const shell_danger_fields::danger& shell_danger_fields::at(const game_board* board, const shell& s, int x, int y, int radius) {
+    if (radius != built_radius) {
+        fields.clear();
+        built_radius = radius;
+    }
+
+    field_key key{board->static_version, board->index(s.get_x(), s.get_y()), s.dir};
+    auto it = fields.find(key);
+    if (it == fields.end()) {
+        int n = board->n;
+        int m = board->m;
+        std::vector<danger> field(board->cells.size());
+
+        // Walk the trajectory exactly like chebyshevDistanceToLine. Each cell keeps the closest
+        // trajectory cell, the earliest one on ties, but only cells within the radius are kept
+        Vector2D linePoint = {s.get_x(), s.get_y()};
+        Vector2D lineDir = {s.dx(), s.dy()};
+        Vector2D newPoint = linePoint + lineDir;
+        int i = 0;
+        while (true) {
+            newPoint.x = (newPoint.x + n) % n;
+            newPoint.y = (newPoint.y + m) % m;
+            if (board->has_wall(newPoint.x, newPoint.y)) {
+                break;
+            }
+
+            for (int py = std::max(0, newPoint.y - radius); py <= std::min(m - 1, newPoint.y + radius); py++) {
+                for (int px = std::max(0, newPoint.x - radius); px <= std::min(n - 1, newPoint.x + radius); px++) {
+                    int dist = std::max(std::abs(px - newPoint.x), std::abs(py - newPoint.y));
+                    danger& d = field[board->index(px, py)];
+                    if (dist < d.trajectory) {
+                        d.trajectory = static_cast<int16_t>(dist);
+                        d.distance = static_cast<int16_t>(std::min(i + 1, static_cast<int>(NO_DANGER) - 1));
+                    }
+                }
+            }
+
+            if ((linePoint.x == newPoint.x && linePoint.y == newPoint.y) || i > max(abs(n * lineDir.x), abs(m * lineDir.y))) {
+                break;
+            }
+            newPoint = newPoint + lineDir;
+            i++;
+        }
+        it = fields.emplace(key, std::move(field)).first;
+    }
+    return it->second[board->index(x, y)];
+}
+
 algorithm::algorithm() {}
 
 void algorithm::other_tanks_turn(game_board* board, shared_ptr<tank> self) {
     for (auto& t : board->tanks) {
         if (t->symbol != self->symbol) {
-            t->turn(board, "shoot"); // Assume everyone else tries to kill us
+            board->turn_tank(t.get(), ActionRequest::Shoot); // Assume everyone else tries to kill us
         }
     }
 }
 
-void algorithm::do_move(game_board* board, shared_ptr<tank> self, const std::string& move) {    
-    board->simulate_step(std::make_tuple(
-        self->get_x(),
-        self->get_y(),
-        move
-    ));
+void algorithm::do_move(game_board* board, shared_ptr<tank> self, ActionRequest move) {    
+    board->simulate_step(self->id, move);
 }
 
-double algorithm::score_single_move(game_board* board, shared_ptr<tank> self, const std::string& move, int lookahead, int stepsSinceBoardUpdate) {
-    unique_ptr<game_board> board_copy = board->dummy_copy();
-    shared_ptr<tank> self_copy = get_self_in_board_copy(board_copy.get(), self);
+double algorithm::score_single_move(game_board* board, shared_ptr<tank> self, ActionRequest move, int lookahead, int stepsSinceBoardUpdate) {
+    if (mode == search_mode::adversarial) {
+        return score_against_responses(board, self, move, lookahead, stepsSinceBoardUpdate);
+    }
 
-    do_move(board_copy.get(), self_copy, move);
-    double score = base_score(board_copy.get(), self_copy, lookahead, stepsSinceBoardUpdate);
+    // Search in place: apply the move on the board itself and revert it once scored
+    size_t mark = board->make_move(self->id, move);
+    double score = base_score(board, self, lookahead, stepsSinceBoardUpdate);
+    board->unmake_move(mark);
 
     return score;
 }
 
+double algorithm::score_against_responses(game_board* board, shared_ptr<tank> self, ActionRequest move, int lookahead, int stepsSinceBoardUpdate) {
+    double alpha = search_alpha;
+    double beta = search_beta;
+
+    // The enemies pick the response that is worst for us
+    double worst = INF;
+    for (int response = 0; response < ENEMY_RESPONSES; response++) {
+        size_t mark = board->begin_move();
+        board->turn_tank(self.get(), move);
+        if (response == 1) {
+            uint64_t before = board->hash();
+            other_tanks_turn(board, self);
+            if (board->hash() == before) {
+                board->unmake_move(mark);
+                break; // No enemy could act, the same position as holding
+            }
+        }
+        board->finish_step();
+
+        search_alpha = alpha;
+        search_beta = std::min(beta, worst);
+        double score = base_score(board, self, lookahead, stepsSinceBoardUpdate);
+        board->unmake_move(mark);
+
+        worst = std::min(worst, score);
+        if (worst <= alpha) {
+            break; // We already have a better move elsewhere
+        }
+    }
+
+    return worst;
+}
+
 double algorithm::score_forward_move(game_board* board, shared_ptr<tank> self, int lookahead, int stepsSinceBoardUpdate) {
-    return score_single_move(board, self, "fw", lookahead, stepsSinceBoardUpdate);
+    return score_single_move(board, self, ActionRequest::MoveForward, lookahead, stepsSinceBoardUpdate);
 }
 
 double algorithm::score_backward_move(game_board* board, shared_ptr<tank> self, int lookahead, int stepsSinceBoardUpdate) {
-    return score_single_move(board, self, "bw", lookahead, stepsSinceBoardUpdate);
+    return score_single_move(board, self, ActionRequest::MoveBackward, lookahead, stepsSinceBoardUpdate);
 }
 
 double algorithm::score_rotate_left_quarter(game_board* board, shared_ptr<tank> self, int lookahead, int stepsSinceBoardUpdate) {
-    return score_single_move(board, self, "r4l", lookahead, stepsSinceBoardUpdate);
+    return score_single_move(board, self, ActionRequest::RotateLeft90, lookahead, stepsSinceBoardUpdate);
 }
 
 double algorithm::score_rotate_right_quarter(game_board* board, shared_ptr<tank> self, int lookahead, int stepsSinceBoardUpdate) {
-    return score_single_move(board, self, "r4r", lookahead, stepsSinceBoardUpdate);
+    return score_single_move(board, self, ActionRequest::RotateRight90, lookahead, stepsSinceBoardUpdate);
 }
 
 double algorithm::score_rotate_left_eighth(game_board* board, shared_ptr<tank> self, int lookahead, int stepsSinceBoardUpdate) {
-    return score_single_move(board, self, "r8l", lookahead, stepsSinceBoardUpdate);
+    return score_single_move(board, self, ActionRequest::RotateLeft45, lookahead, stepsSinceBoardUpdate);
 }
 
 double algorithm::score_rotate_right_eighth(game_board* board, shared_ptr<tank> self, int lookahead, int stepsSinceBoardUpdate) {
-    return score_single_move(board, self, "r8r", lookahead, stepsSinceBoardUpdate);
+    return score_single_move(board, self, ActionRequest::RotateRight45, lookahead, stepsSinceBoardUpdate);
 }
 
 double algorithm::score_shoot(game_board* board, shared_ptr<tank> self, int lookahead, int stepsSinceBoardUpdate) {
@@ -60,56 +252,166 @@ double algorithm::score_shoot(game_board* board, shared_ptr<tank> self, int look
     if (self->shot_timer > 0) {
         return -100000; // Cannot shoot
     }
-    return score_single_move(board, self, "shoot", lookahead, stepsSinceBoardUpdate);
+    return score_single_move(board, self, ActionRequest::Shoot, lookahead, stepsSinceBoardUpdate);
 }
 
 double algorithm::score_skip(game_board* board, shared_ptr<tank> self, int lookahead, int stepsSinceBoardUpdate) {
-    return score_single_move(board, self, "skip", lookahead, stepsSinceBoardUpdate);
+    return score_single_move(board, self, ActionRequest::DoNothing, lookahead, stepsSinceBoardUpdate);
 }
 
 double algorithm::score_update_board(game_board* board, shared_ptr<tank> self, int lookahead) {
-    return score_single_move(board, self, "update", lookahead, 0); // Set stepsSinceBoardUpdate to 0 for board update
+    return score_single_move(board, self, ActionRequest::GetBattleInfo, lookahead, 0); // Set stepsSinceBoardUpdate to 0 for board update
 }
 
 shared_ptr<tank> algorithm::get_self_in_board_copy(game_board* board_copy, shared_ptr<tank> self) {
-    for (auto& t : board_copy->tanks) {
-        if (t->player_number == self->player_number && t->tank_number == self->tank_number) {
-            return t;
-        }
+    tank* t = board_copy->find_tank(self->id);
+    if (t) {
+        return t->shared_from_this();
     }
     std::cout << "Error: Tank not found in board copy!" << std::endl;
     return nullptr;
 }
 
 void algorithm::fetch_walls_and_mines(game_board* board) {
+    // Walls and mines only change when hit, so most nodes of a search reuse the last scan
+    if (board->static_version == walls_and_mines_version) {
+        return;
+    }
+    walls_and_mines_version = board->static_version;
+
     walls.clear();
     mines.clear();
     for (int i = 0; i < board->n; i++) {
         for (int j = 0; j < board->m; j++) {
             cell* c = &board->get_cell(i, j);
             if (c->has_Object()) {
-                if (c->get_Object()->get_symbol() == '#') {
-                    walls.push_back(dynamic_cast<wall*>(c->get_Object()));
-                } else if (c->get_Object()->get_symbol() == '@') {
-                    mines.push_back(dynamic_cast<mine*>(c->get_Object()));
+                if (c->get_Object()->get_kind() == object_kind::wall) {
+                    walls.push_back(static_cast<wall*>(c->get_Object()));
+                } else if (c->get_Object()->get_kind() == object_kind::mine) {
+                    mines.push_back(static_cast<mine*>(c->get_Object()));
                 }
             }
         }
     }
 }
 
-std::pair<std::string, double> algorithm::decide_move(game_board* board, shared_ptr<tank> self, int lookahead, int stepsSinceBoardUpdate, bool first_call) {
-    string state = board->get_board_state();
+void algorithm::begin_decision(game_board* board) {
+    distances.sync(board); // Leaves measure paths over the static layer as it is at the root
+}
+
+double algorithm::score_root_move(int move, game_board* board, shared_ptr<tank> self, int lookahead, int stepsSinceBoardUpdate) {
+    switch (move) {
+        case 0: return score_forward_move(board, self, lookahead, stepsSinceBoardUpdate);
+        case 1: return score_backward_move(board, self, lookahead, stepsSinceBoardUpdate);
+        case 2: return score_rotate_left_quarter(board, self, lookahead, stepsSinceBoardUpdate);
+        case 3: return score_rotate_right_quarter(board, self, lookahead, stepsSinceBoardUpdate);
+        case 4: return score_rotate_left_eighth(board, self, lookahead, stepsSinceBoardUpdate);
+        case 5: return score_rotate_right_eighth(board, self, lookahead, stepsSinceBoardUpdate);
+        case 6: return score_shoot(board, self, lookahead, stepsSinceBoardUpdate);
+        case 7: return score_skip(board, self, lookahead, stepsSinceBoardUpdate);
+        default: return score_update_board(board, self, lookahead);
+    }
+}
 
-    double forward = score_forward_move(board, self, lookahead, stepsSinceBoardUpdate);
-    double backward = score_backward_move(board, self, lookahead, stepsSinceBoardUpdate);
-    double rotate_left_quarter = score_rotate_left_quarter(board, self, lookahead, stepsSinceBoardUpdate);
-    double rotate_right_quarter = score_rotate_right_quarter(board, self, lookahead, stepsSinceBoardUpdate);
-    double rotate_left_eighth = score_rotate_left_eighth(board, self, lookahead, stepsSinceBoardUpdate);
-    double rotate_right_eighth = score_rotate_right_eighth(board, self, lookahead, stepsSinceBoardUpdate);
-    double shoot = score_shoot(board, self, lookahead, stepsSinceBoardUpdate);
-    double skip = score_skip(board, self, lookahead, stepsSinceBoardUpdate);
-    double update_board = score_update_board(board, self, lookahead);
+std::array<double, ROOT_MOVES> algorithm::score_root_moves_parallel(game_board* board, shared_ptr<tank> self, int lookahead, int stepsSinceBoardUpdate) {
+    while (root_workers.size() < ROOT_MOVES) {
+        root_workers.push_back(create_worker());
+    }
+
+    // Search is in place, so every worker gets its own copy (made here, the source is not locked),
+    // all rebuilt from one snapshot of the board
+    board_state root_state;
+    board->save_state(root_state);
+    std::vector<unique_ptr<game_board>> copies;
+    for (int i = 0; i < ROOT_MOVES; i++) {
+        copies.push_back(game_board::from_state(root_state));
+    }
+
+    // Split what is left of the node budget evenly, the deadline is shared as is
+    long node_share = node_limit > 0 ? std::max(1L, (node_limit - nodes_searched) / ROOT_MOVES) : 0;
+
+    std::array<double, ROOT_MOVES> scores{};
+    std::vector<std::function<void()>> tasks;
+    for (int i = 0; i < ROOT_MOVES; i++) {
+        algorithm* worker = root_workers[i].get();
+        worker->mode = mode;
+        worker->search_alpha = -INF; // Workers can not share the best score, so each gets the full window
+        worker->search_beta = INF;
+        worker->nodes_searched = 0;
+        worker->node_limit = node_share;
+        worker->has_deadline = has_deadline;
+        worker->deadline = deadline;
+        worker->search_aborted = false;
+
+        game_board* copy = copies[i].get();
+        shared_ptr<tank> self_copy = get_self_in_board_copy(copy, self);
+        worker->begin_decision(copy);
+        tasks.push_back([worker, copy, self_copy, i, lookahead, stepsSinceBoardUpdate, &scores] {
+            scores[i] = worker->score_root_move(i, copy, self_copy, lookahead, stepsSinceBoardUpdate);
+        });
+    }
+    worker_pool::shared().run_all(tasks);
+
+    for (auto& worker : root_workers) {
+        nodes_searched += worker->nodes_searched;
+        if (worker->search_aborted) search_aborted = true;
+    }
+    return scores;
+}
+
+std::array<double, ROOT_MOVES> algorithm::score_moves(game_board* board, shared_ptr<tank> self, int lookahead, int stepsSinceBoardUpdate, bool first_call) {
+    std::array<double, ROOT_MOVES> scores;
+    scores.fill(-INF);
+
+    if (mode == search_mode::exhaustive) {
+        for (int i = 0; i < ROOT_MOVES; i++) {
+            scores[i] = score_root_move(i, board, self, lookahead, stepsSinceBoardUpdate);
+        }
+        return scores;
+    }
+
+    // Alpha-beta over our own moves. The root always gets the full window, and update only
+    // matters for the choice made at the root (it is not part of the node's value)
+    double alpha = first_call ? -INF : search_alpha;
+    double beta = first_call ? INF : search_beta;
+    double best = -INF;
+    int moves = first_call ? ROOT_MOVES : ROOT_MOVES - 1;
+    for (int i = 0; i < moves; i++) {
+        // At the root, moves tying with the best must come back exact for the tie-breaking
+        search_alpha = first_call ? best - TIE_EPSILON : std::max(alpha, best);
+        search_beta = beta;
+        scores[i] = score_root_move(i, board, self, lookahead, stepsSinceBoardUpdate);
+        if (i < ROOT_MOVES - 1) {
+            best = std::max(best, scores[i]);
+        }
+        if (best >= beta) {
+            break; // The enemies will not let us reach this position
+        }
+    }
+    return scores;
+}
+
+std::pair<ActionRequest, double> algorithm::decide_move(game_board* board, shared_ptr<tank> self, int lookahead, int stepsSinceBoardUpdate, bool first_call) {
+    if (first_call) {
+        begin_decision(board);
+    }
+    return choose_move(board, self, lookahead, stepsSinceBoardUpdate, first_call);
+}
+
+std::pair<ActionRequest, double> algorithm::choose_move(game_board* board, shared_ptr<tank> self, int lookahead, int stepsSinceBoardUpdate, bool first_call) {
+    // The parallel path returns the same scores as the serial one, so the tie-breaking below is unaffected
+    std::array<double, ROOT_MOVES> move_scores = (first_call && parallel_root_moves)
+        ? score_root_moves_parallel(board, self, lookahead, stepsSinceBoardUpdate)
+        : score_moves(board, self, lookahead, stepsSinceBoardUpdate, first_call);
+    double forward = move_scores[0];
+    double backward = move_scores[1];
+    double rotate_left_quarter = move_scores[2];
+    double rotate_right_quarter = move_scores[3];
+    double rotate_left_eighth = move_scores[4];
+    double rotate_right_eighth = move_scores[5];
+    double shoot = move_scores[6];
+    double skip = move_scores[7];
+    double update_board = move_scores[8];
 
     if (DEBUG_ENABLED && first_call) {
         cout << "\nScores for tank " << self->symbol << " at (" << self->get_x() << ", " << self->get_y() << "):" << endl;
@@ -127,36 +429,92 @@ std::pair<std::string, double> algorithm::decide_move(game_board* board, shared_
     vector<double> scores = {forward, backward, rotate_left_quarter, rotate_right_quarter, rotate_left_eighth, rotate_right_eighth, shoot, skip};
     double max_score = *std::max_element(scores.begin(), scores.end());
 
-    if (max_score == forward) return {"fw", max_score};
-    else if (max_score == backward) return {"bw", max_score};
-    else if (max_score == rotate_left_quarter) return {"r4l", max_score};
-    else if (max_score == rotate_right_quarter) return {"r4r", max_score};
-    else if (max_score == rotate_left_eighth) return {"r8l", max_score};
-    else if (max_score == rotate_right_eighth) return {"r8r", max_score};
-    else if (max_score == shoot) return {"shoot", max_score};
-    else if (max_score == update_board) return {"update", max_score};
-    else return {"skip", max_score};
+    if (max_score == forward) return {ActionRequest::MoveForward, max_score};
+    else if (max_score == backward) return {ActionRequest::MoveBackward, max_score};
+    else if (max_score == rotate_left_quarter) return {ActionRequest::RotateLeft90, max_score};
+    else if (max_score == rotate_right_quarter) return {ActionRequest::RotateRight90, max_score};
+    else if (max_score == rotate_left_eighth) return {ActionRequest::RotateLeft45, max_score};
+    else if (max_score == rotate_right_eighth) return {ActionRequest::RotateRight45, max_score};
+    else if (max_score == shoot) return {ActionRequest::Shoot, max_score};
+    else if (max_score == update_board) return {ActionRequest::GetBattleInfo, max_score};
+    else return {ActionRequest::DoNothing, max_score};
+}
+
+bool algorithm::budget_exhausted() {
+    if (search_aborted) return true;
+    nodes_searched++;
+    if (node_limit > 0 && nodes_searched > node_limit) {
+        search_aborted = true;
+    } else if (has_deadline && nodes_searched % DEADLINE_CHECK_INTERVAL == 0 && std::chrono::steady_clock::now() >= deadline) {
+        search_aborted = true;
+    }
+    return search_aborted;
+}
+
+std::pair<ActionRequest, double> algorithm::decide_move_iterative(game_board* board, shared_ptr<tank> self, int max_lookahead, int stepsSinceBoardUpdate, const search_budget& budget) {
+    auto start = std::chrono::steady_clock::now();
+    nodes_searched = 0;
+    search_aborted = false;
+
+    // Every depth searches from the same root, so the per-decision caches are built once and
+    // the deeper iterations reuse what the shallower ones filled in
+    begin_decision(board);
+
+    // Depth 0 is never cut short, so there is always a move to fall back on
+    std::pair<ActionRequest, double> best = choose_move(board, self, 0, stepsSinceBoardUpdate, true);
+    completed_lookahead = 0;
+
+    node_limit = budget.nodes;
+    has_deadline = budget.time.count() > 0;
+    deadline = start + budget.time;
+
+    for (int lookahead = 1; lookahead <= max_lookahead; lookahead++) {
+        std::pair<ActionRequest, double> result = choose_move(board, self, lookahead, stepsSinceBoardUpdate, true);
+        if (search_aborted) {
+            break; // Partial iteration, keep the last completed depth
+        }
+        best = result;
+        completed_lookahead = lookahead;
+    }
+
+    if (DEBUG_ENABLED) {
+        cout << "Anytime search for tank " << self->symbol << ": depth " << completed_lookahead
+             << ", " << nodes_searched << " nodes" << endl;
+    }
+
+    node_limit = 0;
+    has_deadline = false;
+    search_aborted = false;
+    return best;
 }
 
 shell_avoidance_algorithm::shell_avoidance_algorithm() : algorithm(), shell_danger_radius(SHELL_DANGER_RADIUS), shell_danger_distance(SHELL_DANGER_DISTANCE), mine_danger_radius(MINE_DANGER_RADIUS) {}
 
+std::unique_ptr<algorithm> shell_avoidance_algorithm::create_worker() const {
+    return std::make_unique<shell_avoidance_algorithm>();
+}
+
+void shell_avoidance_algorithm::begin_decision(game_board* board) {
+    algorithm::begin_decision(board);
+    shell_dangers.clear(); // Fields are only shared within one decision
+}
+
 double shell_avoidance_algorithm::score_position(game_board* board_copy, shared_ptr<tank> self_copy) {
     double score = 0;
 
     for (auto& s : board_copy->shells) {
         Vector2D shell_pos = {s->get_x(), s->get_y()};
-        Vector2D shell_dir = {s->directionx, s->directiony};
         Vector2D tank_pos = {self_copy->get_x(), self_copy->get_y()};
 
         if (shell_pos.x == tank_pos.x && shell_pos.y == tank_pos.y) {
             return DEATH;
         }
 
-        // Returns pair of distance from the trajectory line and actual distance to the shell
-        std::pair<int, int> dists = chebyshevDistanceToLine(shell_pos, shell_dir, tank_pos, board_copy);
+        // Distance from the trajectory line and along it to the shell, precomputed per shell
+        const shell_danger_fields::danger& d = shell_dangers.at(board_copy, *s, tank_pos.x, tank_pos.y, shell_danger_radius);
 
-        int distance_to_trajectory = dists.first;
-        int distance_to_shell = dists.second;
+        int distance_to_trajectory = d.trajectory;
+        int distance_to_shell = d.distance;
 
         if (distance_to_trajectory <= shell_danger_radius && distance_to_shell <= shell_danger_distance) {
             // cout << "Distance to trajectory: " << distance_to_trajectory << ", Distance to shell: " << distance_to_shell << endl;
@@ -184,14 +542,32 @@ double shell_avoidance_algorithm::score_position(game_board* board_copy, shared_
 }
 
 double shell_avoidance_algorithm::base_score(game_board* board_copy, shared_ptr<tank> self_copy, int lookahead, int stepsSinceBoardUpdate) {
-    // First, check if the tank still exists in the board copy
-    bool tank_exists = false;
-    for (auto& t : board_copy->tanks) {
-        if (t->player_number == self_copy->player_number && t->tank_number == self_copy->tank_number && t->alive) {
-            tank_exists = true;
-            break;
-        }
+    if (budget_exhausted()) {
+        return 0; // The caller discards this iteration
+    }
+    double alpha = search_alpha;
+    double beta = search_beta;
+
+    // Different move orders reach the same board, score each position only once
+    uint64_t key = transposition_table::make_key(board_copy->hash(), self_copy.get(), lookahead, stepsSinceBoardUpdate, mode);
+    double cached;
+    if (tt.probe(key, cached)) {
+        return cached;
+    }
+    double score = score_uncached(board_copy, self_copy, lookahead, stepsSinceBoardUpdate, alpha, beta);
+
+    // Cut-short subtrees and alpha-beta bounds would poison the table, only exact scores go in
+    bool exact = mode == search_mode::exhaustive || (alpha < score && score < beta);
+    if (!search_aborted && exact) {
+        tt.store(key, score);
     }
+    return score;
+}
+
+double shell_avoidance_algorithm::score_uncached(game_board* board_copy, shared_ptr<tank> self_copy, int lookahead, int stepsSinceBoardUpdate, double alpha, double beta) {
+    // First, check if the tank still exists in the board copy
+    tank* self_on_board = board_copy->find_tank(self_copy->id);
+    bool tank_exists = self_on_board && self_on_board->alive;
 
     double score = 0;
 
@@ -228,6 +604,9 @@ double shell_avoidance_algorithm::base_score(game_board* board_copy, shared_ptr<
     }
 
     if (lookahead > 0) {
+        // Child window such that score * 0.4 + next_score * 0.6 stays within (alpha, beta)
+        search_alpha = (alpha - score * 0.4) / 0.6;
+        search_beta = (beta - score * 0.4) / 0.6;
         double next_score = decide_move(board_copy, self_copy, lookahead - 1, stepsSinceBoardUpdate + 1, false).second;
         if (next_score == DEATH) {
             return DEATH;
@@ -240,53 +619,12 @@ double shell_avoidance_algorithm::base_score(game_board* board_copy, shared_ptr<
 }
 
 
-/**
- * Use DFS to find the shortest path from start to end (cannot cross walls).
- */
-int find_shortest_path(Vector2D start, Vector2D end, game_board* board) {
-    std::vector<std::vector<bool>> visited(board->n, std::vector<bool>(board->m, false));
-    std::queue<std::pair<Vector2D, int>> q; // Pair of position and distance
-    q.push({start, 0});
-    visited[start.x][start.y] = true;
-
-    while (!q.empty()) {
-        auto [current, dist] = q.front();
-        q.pop();
-
-        if (current.x == end.x && current.y == end.y) {
-            return dist;
-        }
-
-        for (int dx = -1; dx <= 1; ++dx) {
-            for (int dy = -1; dy <= 1; ++dy) {
-                if (dx == 0 && dy == 0) {
-                    continue; // Skip the current position
-                }
-
-                int new_x = (current.x + dx + board->n) % board->n;
-                int new_y = (current.y + dy + board->m) % board->m;
-
-                if (!visited[new_x][new_y]) {
-                    visited[new_x][new_y] = true;
-
-                    if (board->get_cell(new_x, new_y).has_Object()) {
-                        game_object* obj = board->get_cell(new_x, new_y).get_Object();
-                        if (obj->get_symbol() != '*' && (new_x != end.x || new_y != end.y)) { // Allow everything on the target position
-                            continue; // Skip everything except shells (they move so don't block the path)
-                        }
-                    }
-
-                    Vector2D new_pos = {new_x, new_y};
-                    q.push({new_pos, dist + 1});
-                }
-            }
-        }
-    }
+running_algorithm::running_algorithm() : shell_avoidance_algorithm() {}
 
-    return 100; // No path found
+std::unique_ptr<algorithm> running_algorithm::create_worker() const {
+    return std::make_unique<running_algorithm>();
 }
 
-running_algorithm::running_algorithm() : shell_avoidance_algorithm() {}
 double running_algorithm::score_position(game_board* board_copy, shared_ptr<tank> self_copy) {
     double score = shell_avoidance_algorithm::score_position(board_copy, self_copy);
 
@@ -299,7 +637,7 @@ double running_algorithm::score_position(game_board* board_copy, shared_ptr<tank
             Vector2D tank_pos = {self_copy->get_x(), self_copy->get_y()};
             Vector2D enemy_tank_pos = {t->get_x(), t->get_y()};
 
-            int shortest_path = find_shortest_path(tank_pos, enemy_tank_pos, board_copy);
+            int shortest_path = distances.distance(board_copy, tank_pos, enemy_tank_pos);
 
             if (shortest_path < 7) {
                 score -= pow(10.0 / (double) (shortest_path + 1), 2); // Closer to the enemy tank, lower the score
@@ -313,6 +651,10 @@ double running_algorithm::score_position(game_board* board_copy, shared_ptr<tank
 
 chasing_algorithm::chasing_algorithm() : shell_avoidance_algorithm() {}
 
+std::unique_ptr<algorithm> chasing_algorithm::create_worker() const {
+    return std::make_unique<chasing_algorithm>();
+}
+
 double chasing_algorithm::score_position(game_board* board_copy, shared_ptr<tank> self_copy) {
     double score = shell_avoidance_algorithm::score_position(board_copy, self_copy);
 
@@ -325,7 +667,7 @@ double chasing_algorithm::score_position(game_board* board_copy, shared_ptr<tank
             Vector2D tank_pos = {self_copy->get_x(), self_copy->get_y()};
             Vector2D enemy_tank_pos = {t->get_x(), t->get_y()};
 
-            int shortest_path = find_shortest_path(tank_pos, enemy_tank_pos, board_copy);
+            int shortest_path = distances.distance(board_copy, tank_pos, enemy_tank_pos);
             score += pow(15.0 / (double) (shortest_path + 1), 1.5); // Closer to the enemy tank, higher the score
         }
     }
@@ -338,32 +680,46 @@ double chasing_algorithm::score_shoot(game_board* board, shared_ptr<tank> self,
         return -1000000; // Cannot shoot
     }
 
-    double score = shell_avoidance_algorithm::score_shoot(board, self, lookahead, stepsSinceBoardUpdate);
-
-    if (score == DEATH) {
-        return DEATH;
-    }
-
+    // Bonuses for enemies in the line of fire, added on top of the searched score
+    std::vector<double> bonuses;
     for (auto& t : board->tanks) {
         if (t->player_number != self->player_number) {
             // Check if the enemy tank is in the line of fire
             Vector2D enemy_tank_pos = {t->get_x(), t->get_y()};
-            Vector2D shell_pos = {self->get_x() + self->directionx, self->get_y() + self->directiony};
-            Vector2D shell_dir = {self->directionx, self->directiony};
+            Vector2D shell_pos = {self->get_x() + self->dx(), self->get_y() + self->dy()};
+            Vector2D shell_dir = {self->dx(), self->dy()};
             std::pair<int, int> dists = chebyshevDistanceToLine(shell_pos, shell_dir, enemy_tank_pos, board);
 
             if (dists.first == 0) {
                 // The enemy tank is in the line of fire
                 int distance_to_shell = dists.second;
-                score += pow(20.0 / (double) (distance_to_shell + 1), 2);
+                bonuses.push_back(pow(20.0 / (double) (distance_to_shell + 1), 2));
 
-                if (t->directionx == self->directionx && t->directiony == self->directiony) {
+                if (t->dir == self->dir) {
                     // The enemy tank is moving in the same direction as the shell, will be more difficult to evade
-                    score += 30; // Increase score for shooting in the same direction
+                    bonuses.push_back(30); // Increase score for shooting in the same direction
                 }
             }
         }
     }
 
+    // Shift the alpha-beta window by the bonus so it applies to the searched score
+    double total_bonus = 0;
+    for (double bonus : bonuses) {
+        total_bonus += bonus;
+    }
+    search_alpha -= total_bonus;
+    search_beta -= total_bonus;
+
+    double score = shell_avoidance_algorithm::score_shoot(board, self, lookahead, stepsSinceBoardUpdate);
+
+    if (score == DEATH) {
+        return DEATH;
+    }
+
+    for (double bonus : bonuses) {
+        score += bonus;
+    }
+
     return score;
 }
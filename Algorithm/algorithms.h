@@ -7,6 +7,11 @@
 #include <algorithm>
 #include <unordered_map>
 #include <ctime>
+#include <chrono>
+#include <array>
+#include <memory>
+#include <limits>
+#include <cstdint>
 #include <math.h>
 #include "utils.h"
 #include "Board.h"
@@ -24,6 +29,18 @@ const int SHELL_DANGER_RADIUS = 2; // Shell danger radius (distance from the tra
 const int SHELL_DANGER_DISTANCE = 4; // Shell danger distance
 const int MINE_DANGER_RADIUS = 2;  // Mine danger radius
 
+const int TT_SIZE_LOG2 = 16; // Transposition table holds 2^16 entries (1 MiB)
+const int DEADLINE_CHECK_INTERVAL = 64; // Nodes between clock reads in a timed search
+const int ROOT_MOVES = 9; // fw, bw, r4l, r4r, r8l, r8r, shoot, skip, update
+const int ENEMY_RESPONSES = 2; // Enemies hold, or every enemy shoots (other_tanks_turn)
+const double TIE_EPSILON = 1e-9; // Root window slack so moves tying with the best stay exact
+const double INF = std::numeric_limits<double>::infinity();
+const int NO_PATH = 100; // Distance reported when a tank can not be reached
+
+// exhaustive: every own move at every depth, enemies idle.
+// adversarial: alpha-beta over own moves against the modeled enemy responses
+enum class search_mode : uint8_t { exhaustive, adversarial };
+
 // Forward declarations
 class game_board;
 class tank;
@@ -33,22 +50,137 @@ class wall;
 class cell;
 class Vector2D;
 
+// ==========
+// transposition_table
+// ==========
+// Fixed-size, always-replace cache of base_score results. Each algorithm owns one,
+// so a search thread that owns its algorithm never shares it
+class transposition_table {
+    struct entry {
+        uint64_t key = 0; // 0 marks an empty slot
+        double score = 0;
+    };
+    std::vector<entry> entries;
+
+public:
+    static uint64_t make_key(uint64_t board_hash, const tank* self, int lookahead, int stepsSinceBoardUpdate, search_mode mode);
+    bool probe(uint64_t key, double& score) const;
+    void store(uint64_t key, double score);
+};
+
+// ==========
+// distance_fields
+// ==========
+// Wrap-around BFS distances from enemy cells over the static wall/mine layer. Fields are built
+// on first use and kept until that layer changes, so leaves get an O(1) lookup instead of a BFS
+class distance_fields {
+    int n = 0;
+    int m = 0;
+    uint64_t version = 0; // game_board::static_version the layer was last synced from
+    std::vector<uint8_t> blocked; // Wall or mine, by cell index
+    std::unordered_map<int, std::vector<int>> fields; // Keyed by the source cell index
+
+    static constexpr int UNREACHED = -1; // Field entry of a cell no path leads to
+
+    const std::vector<int>& field_from(int x, int y);
+
+public:
+    void sync(const game_board* board);
+    int distance(const game_board* board, const Vector2D& from, const Vector2D& to);
+};
+
+// ==========
+// shell_danger_fields
+// ==========
+// What chebyshevDistanceToLine reports for a shell, precomputed for every cell near its
+// trajectory. A field depends only on the shell's cell, direction and the wall layer, so it
+// is built once per decision and shared by every leaf that has the shell in that spot
+class shell_danger_fields {
+public:
+    static const int16_t NO_DANGER = INT16_MAX;
+
+    struct danger {
+        int16_t trajectory = NO_DANGER; // Chebyshev distance to the closest trajectory cell
+        int16_t distance = NO_DANGER;   // Steps along the trajectory to that cell
+    };
+
+    void clear() { fields.clear(); }
+    const danger& at(const game_board* board, const shell& s, int x, int y, int radius);
+
+private:
+    struct field_key {
+        uint64_t static_version;
+        int index;
+        direction dir;
+        bool operator==(const field_key& other) const = default;
+    };
+    struct field_key_hash {
+        size_t operator()(const field_key& k) const;
+    };
+
+    int built_radius = -1;
+    std::unordered_map<field_key, std::vector<danger>, field_key_hash> fields;
+};
+
+// Per-decision limits for algorithm::decide_move_iterative, zero disables a limit
+struct search_budget {
+    std::chrono::microseconds time{0};
+    long nodes = 0;
+};
+
 class algorithm {
 protected:
     std::vector<wall*> walls;
     std::vector<mine*> mines;
-    unordered_map<std::string, time_t> board_states;
+    uint64_t walls_and_mines_version = 0; // game_board::static_version the vectors were built from
+    transposition_table tt;
+    distance_fields distances;
+
+    // Anytime search state, only enforced while decide_move_iterative runs
+    long nodes_searched = 0;
+    long node_limit = 0;
+    bool has_deadline = false;
+    std::chrono::steady_clock::time_point deadline;
+    bool search_aborted = false;
+
+    bool budget_exhausted();
+
+    // One search instance per root move for the parallel mode, each with its own table
+    std::vector<std::unique_ptr<algorithm>> root_workers;
+
+    double score_root_move(int move, game_board* board, shared_ptr<tank> self, int lookahead, int stepsSinceBoardUpdate);
+    std::array<double, ROOT_MOVES> score_moves(game_board* board, shared_ptr<tank> self, int lookahead, int stepsSinceBoardUpdate, bool first_call);
+    std::array<double, ROOT_MOVES> score_root_moves_parallel(game_board* board, shared_ptr<tank> self, int lookahead, int stepsSinceBoardUpdate);
+
+    // Refresh the per-decision caches before searching from a new root
+    virtual void begin_decision(game_board* board);
+
+    // decide_move without the cache refresh; first_call scores every root move (update included)
+    // with the full window, as the top of a decision
+    std::pair<ActionRequest, double> choose_move(game_board* board, shared_ptr<tank> self, int lookahead, int stepsSinceBoardUpdate, bool first_call);
+
+    // Alpha-beta window for the next node entered, handed down through the score_* virtuals
+    double search_alpha = -INF;
+    double search_beta = INF;
+
+    double score_against_responses(game_board* board, shared_ptr<tank> self, ActionRequest move, int lookahead, int stepsSinceBoardUpdate);
 
 public:
+    bool parallel_root_moves = false; // Score the root moves on worker_pool::shared()
+    search_mode mode = search_mode::exhaustive;
+
     algorithm();
 
     virtual ~algorithm() = default;
 
+    // Fresh instance of the same strategy, used as a parallel search worker
+    virtual std::unique_ptr<algorithm> create_worker() const = 0;
+
     virtual double base_score(game_board* board_copy, shared_ptr<tank> self_copy, int lookahead, int stepsSinceBoardUpdate) = 0;
 
     void other_tanks_turn(game_board* board, shared_ptr<tank> self);
-    void do_move(game_board* board, shared_ptr<tank> self, const std::string& move);
-    double score_single_move(game_board* board, shared_ptr<tank> self, const std::string& move, int lookahead, int stepsSinceBoardUpdate);
+    void do_move(game_board* board, shared_ptr<tank> self, ActionRequest move);
+    double score_single_move(game_board* board, shared_ptr<tank> self, ActionRequest move, int lookahead, int stepsSinceBoardUpdate);
     virtual double score_forward_move(game_board* board, shared_ptr<tank> self, int lookahead, int stepsSinceBoardUpdate);
     virtual double score_backward_move(game_board* board, shared_ptr<tank> self, int lookahead, int stepsSinceBoardUpdate);
     virtual double score_rotate_left_quarter(game_board* board, shared_ptr<tank> self, int lookahead, int stepsSinceBoardUpdate);
@@ -60,7 +192,11 @@ public:
     virtual double score_update_board(game_board* board, shared_ptr<tank> self, int lookahead);
     shared_ptr<tank> get_self_in_board_copy(game_board* board_copy, shared_ptr<tank> self);
     void fetch_walls_and_mines(game_board* board);
-    std::pair<std::string, double> decide_move(game_board* board, shared_ptr<tank> self, int lookahead, int stepsSinceBoardUpdate, bool first_call = true);
+    std::pair<ActionRequest, double> decide_move(game_board* board, shared_ptr<tank> self, int lookahead, int stepsSinceBoardUpdate, bool first_call = true);
+    std::pair<ActionRequest, double> decide_move_iterative(game_board* board, shared_ptr<tank> self, int max_lookahead, int stepsSinceBoardUpdate, const search_budget& budget);
+
+    int completed_lookahead = -1; // Depth of the last decide_move_iterative result
+    long get_nodes_searched() const { return nodes_searched; }
 };
 
 class shell_avoidance_algorithm : public algorithm {
@@ -68,18 +204,22 @@ protected:
     int shell_danger_radius;
     int shell_danger_distance;
     int mine_danger_radius;
+    shell_danger_fields shell_dangers;
+
+    virtual void begin_decision(game_board* board) override;
 
 public:
     shell_avoidance_algorithm();
+    virtual std::unique_ptr<algorithm> create_worker() const override;
     virtual double score_position(game_board* board_copy, shared_ptr<tank> self_copy);
     virtual double base_score(game_board* board_copy, shared_ptr<tank> self_copy, int lookahead, int stepsSinceBoardUpdate) override;
+    double score_uncached(game_board* board_copy, shared_ptr<tank> self_copy, int lookahead, int stepsSinceBoardUpdate, double alpha, double beta);
 };
 
-int find_shortest_path(Vector2D start, Vector2D end, game_board* board_copy);
-
 class chasing_algorithm : public shell_avoidance_algorithm {
 public:
     chasing_algorithm();
+    virtual std::unique_ptr<algorithm> create_worker() const override;
     virtual double score_position(game_board* board_copy, shared_ptr<tank> self_copy) override;
     virtual double score_shoot(game_board* board, shared_ptr<tank> self, int lookahead, int stepsSinceBoardUpdate) override;
 };
@@ -87,6 +227,7 @@ public:
 class running_algorithm : public shell_avoidance_algorithm {
 public:
     running_algorithm();
+    virtual std::unique_ptr<algorithm> create_worker() const override;
     virtual double score_position(game_board* board_copy, shared_ptr<tank> self_copy) override;
 };
 
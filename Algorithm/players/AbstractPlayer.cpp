@@ -85,29 +85,39 @@ void AbstractPlayer::updateTankWithBattleInfo(TankAlgorithm &tankAlg, SatelliteV
     // std::cout << "[DEBUG] updateTankWithBattleInfo: starting update for player "
             //   << player_index << "\n";
 
+    // All tanks asking in the same round see the same view version; reading it again would
+    // only match the board against itself, so the board is updated once per version
+    SatelliteViewImpl *view_impl = dynamic_cast<SatelliteViewImpl *>(&satellite_view);
+    uint64_t view_version = view_impl ? view_impl->getVersion() : 0;
+
     if (!boardInitialized) {
         // std::cout << "[DEBUG] updateTankWithBattleInfo: board not initialized, calling initBoard\n";
         initBoard(satellite_view);
         boardInitialized = true;
-    } else {
+        battleStateStale = true;
+    } else if (view_version == 0 || view_version != lastViewVersion) {
         // std::cout << "[DEBUG] updateTankWithBattleInfo: board already initialized, calling updateBoard\n";
         updateBoard(satellite_view);
+        battleStateStale = true;
     }
+    lastViewVersion = view_version;
 
     if (DEBUG_ENABLED) {
         std::cout << "[DEBUG] updateTankWithBattleInfo: completed update for player "
                   << player_index << "\n";
     }
 
-    // Clone board
-    unique_ptr<game_board> board_copy = board->dummy_copy();
-    // Create a BattleInfo object with the cloned board
-    MyBattleInfo battle_info(std::move(board_copy));
+    // Tanks share one snapshot of the board until it changes, each builds its own board from it
+    if (battleStateStale) {
+        board->save_state(battle_state.rewrite());
+        battleStateStale = false;
+    }
+    MyBattleInfo battle_info(battle_state.share());
     // Update the tank's algorithm with the battle info
     tankAlg.updateBattleInfo(battle_info);
 
     // The tank alg will give us some extra info it knows about its own tank
-    tuple<int, int, int, int, string> self_tank = battle_info.getSelfTank();
+    tuple<int, int, int, int, gear_state> self_tank = battle_info.getSelfTank();
 
     int x = get<0>(self_tank);
     int y = get<1>(self_tank);
@@ -121,18 +131,25 @@ void AbstractPlayer::updateTankWithBattleInfo(TankAlgorithm &tankAlg, SatelliteV
     // Update the tank's position and direction
     int direction_x = get<2>(self_tank);
     int direction_y = get<3>(self_tank);
-    string gear = get<4>(self_tank);
-    tank *t = dynamic_cast<tank *>(obj);
-    if (!t)
+    gear_state gear = get<4>(self_tank);
+    if (obj->get_kind() != object_kind::tank)
     {
         throw std::runtime_error("Object at self tank's position is not a tank");
     }
+    tank *t = static_cast<tank *>(obj);
+
+    direction dir = direction_of(direction_x, direction_y);
+    if (t->get_x() == x && t->get_y() == y && t->dir == dir && t->gear == gear)
+    {
+        return; // The tank agrees with the board, the shared snapshot stays valid
+    }
 
     t->set_x(x);
     t->set_y(y);
-    t->directionx = direction_x;
-    t->directiony = direction_y;
+    t->dir = dir;
     t->gear = gear;
+    board->rehash(t);
+    battleStateStale = true;
 }
 
 
@@ -150,11 +167,14 @@ void AbstractPlayer::updateBoard(SatelliteView &view)
     }
     
     // Update tanks and shells based on the satellite view
-    vector<tuple<int, int, int, int, string>> tank_data;
+    vector<tuple<int, int, int, int, gear_state, int>> tank_data;
     vector<tuple<int, int, int, int>> shell_data;
     
     int tanks_found = 0;
     int shells_found = 0;
+    unordered_set<const tank*> matched_tanks; // Each board tank stands for one view tank at most
+
+    read_view_grid(view, width, height, viewCells);
     
     for (size_t x = 0; x < width; ++x)
     {
@@ -162,7 +182,7 @@ void AbstractPlayer::updateBoard(SatelliteView &view)
         {
             Vector2D target_pos = {x, y};
 
-            char symbol = view.getObjectAt(x, y);
+            char symbol = viewCells[y * width + x];
             char real_symbol = isTank(symbol, player_index);
             if (real_symbol)
             {
@@ -171,9 +191,10 @@ void AbstractPlayer::updateBoard(SatelliteView &view)
                     cout << "[DEBUG] updateBoard: found tank '" << real_symbol << "' at (" << x << ", " << y << ")" << endl;
                 }
                 
-                tank *closest_tank = findClosestTank(target_pos, real_symbol);
+                tank *closest_tank = findClosestTank(target_pos, real_symbol, matched_tanks);
                 if (closest_tank)
                 {
+                    matched_tanks.insert(closest_tank);
                     Vector2D tank_pos = {closest_tank->get_x(), closest_tank->get_y()};
                     Vector2D direction = target_pos - tank_pos;
                     if (DEBUG_ENABLED) {
@@ -188,9 +209,10 @@ void AbstractPlayer::updateBoard(SatelliteView &view)
                         tank_data.push_back(make_tuple(
                             closest_tank->get_x(),
                             closest_tank->get_y(),
-                            closest_tank->directionx,
-                            closest_tank->directiony,
-                            closest_tank->gear));
+                            closest_tank->dx(),
+                            closest_tank->dy(),
+                            closest_tank->gear,
+                            closest_tank->tank_number));
                     } else {
                         int direction_x = 0, direction_y = 0;
                         if (direction.x > 0)
@@ -201,13 +223,13 @@ void AbstractPlayer::updateBoard(SatelliteView &view)
                             direction_y = 1;
                         else if (direction.y < 0)
                             direction_y = -1;
-                        string gear = "forward"; // Default gear, we don't predict gears.
+                        gear_state gear = gear_state::forward; // Default gear, we don't predict gears.
 
                         if (DEBUG_ENABLED) {
                             cout << "[DEBUG] updateBoard: tank moved, new direction (" << direction_x << ", " << direction_y << ")" << endl;
                         }
                         tank_data.push_back(make_tuple(
-                            x, y, direction_x, direction_y, gear));
+                            x, y, direction_x, direction_y, gear, closest_tank->tank_number));
                     }
                 }
                 else
@@ -227,8 +249,8 @@ void AbstractPlayer::updateBoard(SatelliteView &view)
                 shell *closest_shell = findClosestShell(target_pos);
                 if (closest_shell)
                 {
-                    int direction_x = closest_shell->directionx;
-                    int direction_y = closest_shell->directiony;
+                    int direction_x = closest_shell->dx();
+                    int direction_y = closest_shell->dy();
                     if (DEBUG_ENABLED) {
                         cout << "[DEBUG] updateBoard: shell direction (" << direction_x << ", " << direction_y << ")" << endl;
                     }
@@ -260,50 +282,25 @@ void AbstractPlayer::updateBoard(SatelliteView &view)
 /**
  * Find the closest tank to a given position with a specific symbol.
  */
-tank *AbstractPlayer::findClosestTank(Vector2D target_pos, char symbol)
+tank *AbstractPlayer::findClosestTank(Vector2D target_pos, char symbol, const unordered_set<const tank*>& taken)
 {
-    if (DEBUG_ENABLED) {
-        cout << "[DEBUG] findClosestTank: searching for tank '" << symbol << "' closest to (" << target_pos.x << ", " << target_pos.y << ")" << endl;
-    }
-    
     tank *closest_tank = nullptr;
     double min_distance = std::numeric_limits<double>::max();
-    int tanks_checked = 0;
 
     for (const auto &t : board->tanks)
     {
-        tanks_checked++;
-        if (t->get_symbol() == symbol)
+        if (t->get_symbol() == symbol && !taken.count(t.get()))
         {
             Vector2D tank_pos = {t->get_x(), t->get_y()};
             double distance = tank_pos.chebyshevDistance(target_pos);
-            if (DEBUG_ENABLED) {
-                cout << "[DEBUG] findClosestTank: tank '" << symbol << "' at (" << tank_pos.x << ", " << tank_pos.y << "), distance=" << distance << endl;
-            }
-            
             if (distance < min_distance)
             {
                 min_distance = distance;
                 closest_tank = t.get();
-                if (DEBUG_ENABLED) {
-                    cout << "[DEBUG] findClosestTank: new closest tank found, distance=" << min_distance << endl;
-                }
             }
         }
     }
 
-    if (DEBUG_ENABLED) {
-        cout << "[DEBUG] findClosestTank: checked " << tanks_checked << " tanks, ";
-        if (closest_tank)
-        {
-            cout << "found closest at (" << closest_tank->get_x() << ", " << closest_tank->get_y() << "), distance=" << min_distance << endl;
-        }
-        else
-        {
-            cout << "no tank found with symbol '" << symbol << "'" << endl;
-        }
-    }
-
     return closest_tank;
 }
 
@@ -328,8 +325,8 @@ shell *AbstractPlayer::findClosestShell(Vector2D target_pos)
         Vector2D shell_pos = {x, y};
         Vector2D direction_to_shell = target_pos - shell_pos;
         // Compare with shells's actual direction
-        int direction_x = s->directionx;
-        int direction_y = s->directiony;
+        int direction_x = s->dx();
+        int direction_y = s->dy();
         
         if (DEBUG_ENABLED) {
             cout << "[DEBUG] findClosestShell: checking shell at (" << x << ", " << y << "), direction (" << direction_x << ", " << direction_y << ")" << endl;
@@ -457,7 +454,7 @@ void AbstractPlayer::initBoard(SatelliteView &view)
     }
     
     // Get initial tank data from the satellite view
-    vector<tuple<int, int, int, int, string>> tank_data = initialParseSatView(view);
+    vector<tuple<int, int, int, int, gear_state, int>> tank_data = initialParseSatView(view);
     
     if (DEBUG_ENABLED) {
         cout << "[DEBUG] initBoard: found " << tank_data.size() << " tanks during initial parse" << endl;
@@ -479,21 +476,23 @@ void AbstractPlayer::initBoard(SatelliteView &view)
 /**
  * Parse tanks from the initial satellite view.
  */
-vector<tuple<int, int, int, int, string>> AbstractPlayer::initialParseSatView(SatelliteView &view)
+vector<tuple<int, int, int, int, gear_state, int>> AbstractPlayer::initialParseSatView(SatelliteView &view)
 {
     if (DEBUG_ENABLED) {
         cout << "[DEBUG] initialParseSatView: parsing initial satellite view for player " << player_index << endl;
     }
     
-    vector<tuple<int, int, int, int, string>> tank_data;
+    vector<tuple<int, int, int, int, gear_state, int>> tank_data;
     int tanks_found = 0;
+
+    read_view_grid(view, width, height, viewCells);
     
     // Iterate through the view to find all the items
     for (size_t x = 0; x < width; ++x)
     {
         for (size_t y = 0; y < height; ++y)
         {
-            char symbol = view.getObjectAt(x, y);
+            char symbol = viewCells[y * width + x];
             if (isTank(symbol, player_index))
             {
                 tanks_found++;
@@ -511,7 +510,7 @@ vector<tuple<int, int, int, int, string>> AbstractPlayer::initialParseSatView(Sa
     return tank_data;
 }
 
-tuple<int, int, int, int, string> AbstractPlayer::initTank(SatelliteView &view, int x, int y)
+tuple<int, int, int, int, gear_state, int> AbstractPlayer::initTank(SatelliteView &view, int x, int y)
 {
     char symbol = view.getObjectAt(x, y);
     if (DEBUG_ENABLED) {
@@ -539,13 +538,13 @@ tuple<int, int, int, int, string> AbstractPlayer::initTank(SatelliteView &view,
         if (DEBUG_ENABLED) {
             cout << "[DEBUG] initTank: tank faces left (-1, 0)" << endl;
         }
-        return make_tuple(x, y, -1, 0, "forward"); // Tank 1 faces left
+        return make_tuple(x, y, -1, 0, gear_state::forward, -1); // Tank 1 faces left, numbered by generate_board
     }
     else
     {
         if (DEBUG_ENABLED) {
             cout << "[DEBUG] initTank: tank faces right (1, 0)" << endl;
         }
-        return make_tuple(x, y, 1, 0, "forward"); // Other tanks face right
+        return make_tuple(x, y, 1, 0, gear_state::forward, -1); // Other tanks face right
     }
 }
@@ -3,9 +3,11 @@
 #include "../../common/TankAlgorithm.h"
 #include "../../common/SatelliteView.h"
 #include "../../GameManager/SatelliteViewImpl.h"
+#include "../../GameManager/satellite_grid.h"
 #include "../../GameManager/MyBattleInfo.h"
 #include "../../GameManager/Board.h"
 #include "../../GameManager/utils.h"
+#include <unordered_set>
 #include <vector>
 
 using namespace std;
@@ -25,6 +27,10 @@ private:
 
     bool boardInitialized = false; // Flag to check if the board is initialized
     unique_ptr<game_board> board;
+    vector<char> viewCells; // The last view read, row-major, reused between updates
+    uint64_t lastViewVersion = 0; // Version of the view the board was last updated from
+    shared_board_state battle_state; // Handed to tanks in MyBattleInfo
+    bool battleStateStale = true; // The board changed since battle_state was taken
 
 public:
     size_t max_steps; // Maximum steps allowed
@@ -43,9 +49,10 @@ public:
     void updateBoard(SatelliteView &view);
 
     /**
-     * Find the closest tank to a given position with a specific symbol.
+     * Find the closest tank to a given position with a specific symbol, skipping the tanks
+     * already matched to another position.
      */
-    tank* findClosestTank(Vector2D target_pos, char symbol);
+    tank* findClosestTank(Vector2D target_pos, char symbol, const unordered_set<const tank*>& taken);
 
     /**
      * Find the closest shell to a given position, which matches the shells movement (direction and moves 2 steps at a time).
@@ -61,7 +68,7 @@ public:
     /**
      * Parse tanks from the initial satellite view.
      */
-    vector<tuple<int, int, int, int, string>> initialParseSatView(SatelliteView &view);
+    vector<tuple<int, int, int, int, gear_state, int>> initialParseSatView(SatelliteView &view);
 
-    virtual tuple<int, int, int, int, string> initTank(SatelliteView &view, int x, int y);
+    virtual tuple<int, int, int, int, gear_state, int> initTank(SatelliteView &view, int x, int y);
 };
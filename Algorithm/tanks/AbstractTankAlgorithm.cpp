@@ -1,5 +1,4 @@
 #include "AbstractTankAlgorithm.h"
-#include "../../common/ActionUtils.h"
 
 using namespace std;
 
@@ -20,8 +19,9 @@ void AbstractTankAlgorithm::initialize()
 ActionRequest AbstractTankAlgorithm::getAction()
 {
     ActionRequest action;
-    if (!board)
+    if (!snapshot || !ownBoard())
     {
+        // Nothing to search on, or we lost track of our own tank: ask for a fresh view
         action = ActionRequest::GetBattleInfo;
     }
     else
@@ -37,30 +37,69 @@ ActionRequest AbstractTankAlgorithm::getAction()
     {
         stepsSinceBoardUpdate++;
 
-        board->simulate_step(make_tuple(
-            selfTank->get_x(),
-            selfTank->get_y(),
-            actionToString(action)));
+        board->simulate_step(selfTank->id, action);
         
-        // Update the self tank's position after the action
-        for (auto &t : board->tanks)
+        // Update the self tank's position after the action; a tank gone from our board is
+        // not kept around, the next turn asks for battle info instead
+        if (tank *t = board->find_tank(selfTank->id))
         {
-            if (t->player_number == playerIndex && t->tank_number == tankIndex)
-            {
-                selfTank = t;
-                break;
-            }
+            selfTank = t->shared_from_this();
+        }
+        else
+        {
+            selfTank.reset();
         }
     }
 
     return action;
 }
 
+bool AbstractTankAlgorithm::ownBoard()
+{
+    if (board)
+    {
+        return selfTank != nullptr;
+    }
+
+    board = game_board::from_state(*snapshot);
+
+    tank *t = board->find_tank(tank_entity_id(playerIndex, tankIndex));
+    if (!t)
+    {
+        // selfTank belonged to the previous board, which is gone
+        selfTank.reset();
+        return false;
+    }
+    if (selfTank)
+    {
+        // Update board tank according to the self tank's position
+        t->set_x(selfTank->get_x());
+        t->set_y(selfTank->get_y());
+        t->dir = selfTank->dir;
+        t->gear = selfTank->gear;
+        board->rehash(t);
+    }
+    selfTank = t->shared_from_this();
+    return true;
+}
+
 ActionRequest AbstractTankAlgorithm::getActionInternal()
 {
+    if (!algo)
+    {
+        initialize();
+    }
+
     // Use the algorithm to decide the action
-    auto [action, score] = algo->decide_move(board.get(), selfTank, 2, stepsSinceBoardUpdate);
-    return stringToAction(action);
+    algo->parallel_root_moves = parallelSearch;
+    algo->mode = searchMode;
+    if (anytimeSearch)
+    {
+        auto [action, score] = algo->decide_move_iterative(board.get(), selfTank, maxLookahead, stepsSinceBoardUpdate, budget);
+        return action;
+    }
+    auto [action, score] = algo->decide_move(board.get(), selfTank, lookahead, stepsSinceBoardUpdate);
+    return action;
 }
 
 void AbstractTankAlgorithm::updateBattleInfo(BattleInfo &info)
@@ -71,49 +110,32 @@ void AbstractTankAlgorithm::updateBattleInfo(BattleInfo &info)
         throw std::runtime_error("AbstractTankAlgorithm requires MyBattleInfo for battle info updates");
     }
 
-    bool firstTime = !board;
+    // Keep the shared snapshot and only build a board of our own once we act on it
+    snapshot = my_info->getState();
+    board.reset();
 
-    board = my_info->getBoard()->dummy_copy();
-
-    if (firstTime)
+    if (selfTank)
     {
-        for (auto &t : board->tanks)
-        {
-            if (t->player_number == playerIndex && t->tank_number == tankIndex)
-            {
-                selfTank = t;
-                break;
-            }
-        }
-    } else {
-        // Update board tank according to the self tank's position
-        if (selfTank)
-        {
-            for (auto &t : board->tanks)
-            {
-                if (t->player_number == playerIndex && t->tank_number == tankIndex)
-                {
-                    t->set_x(selfTank->get_x());
-                    t->set_y(selfTank->get_y());
-                    t->directionx = selfTank->directionx;
-                    t->directiony = selfTank->directiony;
-                    t->gear = selfTank->gear;
-                    selfTank = t;
-                    break;
-                }
-            }
-        }
+        // The self tank we tracked wins over the snapshot, ownBoard() moves the board tank to it
+        my_info->setSelfTank(make_tuple(
+                selfTank->get_x(),
+                selfTank->get_y(),
+                selfTank->dx(),
+                selfTank->dy(),
+                selfTank->gear));
+        return;
     }
 
-    if (!selfTank)
+    const tank_record *self = snapshot->find_tank(tank_entity_id(playerIndex, tankIndex));
+    if (!self)
     {
         throw std::runtime_error("Self tank not found in the board");
     }
-    
+
     my_info->setSelfTank(make_tuple(
-            selfTank->get_x(),
-            selfTank->get_y(),
-            selfTank->directionx,
-            selfTank->directiony,
-            selfTank->gear));
+            self->x,
+            self->y,
+            DIR_DX[self->dir],
+            DIR_DY[self->dir],
+            self->gear));
 }
@@ -12,11 +12,30 @@ public:
     int playerIndex; // Player index
     int tankIndex; // Tank index
     int stepsSinceBoardUpdate = 0; // Steps since the last board update
+    int lookahead = 3; // Fixed search depth when anytimeSearch is off
+
+    // Anytime mode: deepen up to maxLookahead until the budget runs out, keeping the last full depth.
+    // Only the node budget is on by default, so a replay makes the same moves on any machine; a
+    // time cap (budget.time) bounds large maps where leaves are slow, at the cost of that
+    bool anytimeSearch = true;
+    int maxLookahead = 6;
+    search_budget budget{std::chrono::microseconds(0), 4000};
+
+    // Alpha-beta against modeled enemy fire instead of the exhaustive, opponent-blind search
+    search_mode searchMode = search_mode::adversarial;
+
+    // Score the root moves on the shared worker pool, worth it when one game owns a many-core box
+    bool parallelSearch = false;
 protected:
     unique_ptr<algorithm> algo; // Pointer to the algorithm used by this tank
 
-    unique_ptr<game_board> board; // Pointer to the game board
+    board_snapshot snapshot; // Last battle info, shared with the player and its other tanks
+    unique_ptr<game_board> board; // Our own copy of the snapshot, built on first use
     shared_ptr<tank> selfTank = nullptr; // Pointer to the self tank
+
+    // Builds board from the snapshot unless we already have it; false (and no selfTank) when
+    // our tank is not on it
+    bool ownBoard();
 public:
     AbstractTankAlgorithm(int player_index, int tank_index);
     virtual ~AbstractTankAlgorithm() = default;
@@ -0,0 +1,79 @@
+#include "worker_pool.h"
+#include <algorithm>
+#include <exception>
+
+worker_pool::worker_pool(size_t thread_count) {
+    for (size_t i = 0; i < thread_count; i++) {
+        threads.emplace_back(&worker_pool::worker_loop, this);
+    }
+}
+
+worker_pool::~worker_pool() {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        stopping = true;
+    }
+    work_cv.notify_all();
+    for (auto& t : threads) {
+        t.join();
+    }
+}
+
+worker_pool& worker_pool::shared() {
+    static worker_pool pool(std::max(1u, std::thread::hardware_concurrency()));
+    return pool;
+}
+
+void worker_pool::worker_loop() {
+    std::unique_lock<std::mutex> lock(mtx);
+    while (true) {
+        work_cv.wait(lock, [this] { return stopping || !queue.empty(); });
+        if (queue.empty()) return; // Stopping and nothing left to run
+
+        std::function<void()> task = std::move(queue.front());
+        queue.pop_front();
+        lock.unlock();
+        task();
+        lock.lock();
+        done_cv.notify_all();
+    }
+}
+
+void worker_pool::run_all(std::vector<std::function<void()>>& tasks) {
+    size_t remaining = tasks.size();
+    std::exception_ptr error;
+
+    std::unique_lock<std::mutex> lock(mtx);
+    for (auto& task : tasks) {
+        // The batch counter and error slot are only touched under mtx
+        queue.push_back([this, &task, &remaining, &error] {
+            std::exception_ptr caught;
+            try {
+                task();
+            } catch (...) {
+                caught = std::current_exception();
+            }
+            std::lock_guard<std::mutex> guard(mtx);
+            if (caught && !error) error = caught;
+            remaining--;
+        });
+    }
+    work_cv.notify_all();
+
+    while (remaining > 0) {
+        if (!queue.empty()) {
+            // Help out instead of idling, the task may belong to another batch
+            std::function<void()> task = std::move(queue.front());
+            queue.pop_front();
+            lock.unlock();
+            task();
+            lock.lock();
+            done_cv.notify_all();
+        } else {
+            done_cv.wait(lock);
+        }
+    }
+    lock.unlock();
+
+    if (error) std::rethrow_exception(error);
+}
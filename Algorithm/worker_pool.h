@@ -0,0 +1,44 @@
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// ==========
+// worker_pool
+// ==========
+// Persistent threads draining one shared task queue. run_all() blocks until its own batch
+// is done and lends the calling thread to the queue meanwhile, so batches can be submitted
+// from several threads (or from inside a task) without deadlocking
+class worker_pool {
+public:
+    explicit worker_pool(size_t thread_count);
+    ~worker_pool();
+
+    worker_pool(const worker_pool&) = delete;
+    worker_pool& operator=(const worker_pool&) = delete;
+
+    // Runs every task and rethrows the first exception any of them threw
+    void run_all(std::vector<std::function<void()>>& tasks);
+
+    size_t size() const { return threads.size(); }
+
+    // Process-wide pool sized to the hardware
+    static worker_pool& shared();
+
+private:
+    std::vector<std::thread> threads;
+    std::deque<std::function<void()>> queue;
+    std::mutex mtx;
+    std::condition_variable work_cv; // Signalled when tasks are queued or the pool stops
+    std::condition_variable done_cv; // Signalled when a task finishes
+    bool stopping = false;
+
+    void worker_loop();
+};
+
+#endif // WORKER_POOL_H
@@ -0,0 +1,308 @@
+// Micro-benchmarks for the engine hot paths in Board.cpp / GameObject.cpp / SatelliteViewImpl.cpp
+//
+//   ./engine_bench [sizes=10,100,1000] [wall_density=0.1] [mine_density=0.02]
+//                  [tank_density=0.005] [shell_density=0.01] [seed=1]
+//                  [min_time=0.2] [format=csv|json] [out=<file>]
+//
+// Every size is a square synthetic board with at least one tank per player and MIN_SHELLS shells,
+// however small the densities make them, so every row times real work. Each benchmark runs until min_time seconds of timed
+// work are collected (at least 3 runs, at most ten times min_time of wall clock); set-up that
+// is not part of the measured call (fresh board copies for the mutating steps) is kept out of
+// the timings.
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <unordered_set>
+#include <vector>
+#include "Board.h"
+#include "GameObject.h"
+#include "SatelliteViewImpl.h"
+#include "map_generator.h"
+
+using bench_clock = std::chrono::steady_clock;
+
+struct bench_config {
+    std::vector<int> sizes = { 10, 100, 1000 };
+    double wall_density = 0.10;
+    double mine_density = 0.02;
+    double tank_density = 0.005;
+    double shell_density = 0.01;
+    uint32_t seed = 1;
+    double min_time = 0.2; // Seconds of timed work per benchmark
+    std::string format = "csv";
+    std::string out;
+};
+
+const int MIN_SHELLS = 4; // Shells on every board, the smallest sizes included
+
+struct bench_result {
+    std::string name;
+    int width;
+    int height;
+    size_t tanks;
+    size_t shells;
+    long iterations;
+    double mean_ns;
+    double min_ns;
+};
+
+// ==========
+// grid_view
+// ==========
+// SatelliteView over a row-major char grid, what generate_board reads a synthetic map from
+class grid_view : public SatelliteView {
+public:
+    int width;
+    int height;
+    std::vector<char> cells;
+
+    grid_view(int width, int height) : width(width), height(height), cells(width * height, ' ') {}
+    char getObjectAt(size_t x, size_t y) const override {
+        return x < static_cast<size_t>(width) && y < static_cast<size_t>(height) ? cells[y * width + x] : '&';
+    }
+};
+
+struct synthetic_map {
+    grid_view view;
+    std::vector<std::tuple<int, int, int, int>> shell_data;
+    std::vector<std::tuple<int, int, int, int, gear_state, int>> tank_data;
+};
+
+// Walls, mines and tanks come from map_generator (without the border ring, so shells wrap);
+// the map file format has no shells, those are dropped on random free cells afterwards
+static synthetic_map make_map(const bench_config& cfg, int size) {
+    map_params params;
+    params.rows = size;
+    params.cols = size;
+    params.wall_density = cfg.wall_density;
+    params.mine_density = cfg.mine_density;
+    params.tanks1 = params.tanks2 = std::max(1, static_cast<int>(cfg.tank_density * size * size / 2 + 0.5));
+    params.border = false;
+    params.seed = cfg.seed + static_cast<uint32_t>(size);
+    std::vector<std::string> rows = map_generator(params).generate();
+
+    std::mt19937 rng(params.seed);
+    std::vector<std::pair<int, int>> free_cells;
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+            if (rows[y][x] == ' ') free_cells.emplace_back(x, y);
+        }
+    }
+    size_t shells = std::max(MIN_SHELLS, static_cast<int>(cfg.shell_density * size * size + 0.5));
+    shells = std::min(shells, free_cells.size());
+    for (size_t i = 0; i < shells; ++i) {
+        size_t j = i + rng() % (free_cells.size() - i);
+        std::swap(free_cells[i], free_cells[j]);
+        rows[free_cells[i].second][free_cells[i].first] = '*';
+    }
+
+    synthetic_map map{ grid_view(size, size), {}, {} };
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+            char ch = rows[y][x];
+            map.view.cells[y * size + x] = ch;
+
+            if (ch == '*' || ch == '1' || ch == '2') {
+                direction d = static_cast<direction>(rng() % DIR_COUNT);
+                if (ch == '*') map.shell_data.emplace_back(x, y, DIR_DX[d], DIR_DY[d]);
+                else map.tank_data.emplace_back(x, y, DIR_DX[d], DIR_DY[d], gear_state::forward, -1);
+            }
+        }
+    }
+    return map;
+}
+
+// Runs op until min_time of timed work is collected; op returns the time it wants counted. The
+// untimed set-up of a cheap op can cost far more than the op, so ten times min_time of wall
+// clock ends the run as well
+static std::pair<long, std::pair<double, double>> measure(double min_time, const std::function<bench_clock::duration()>& op) {
+    long iterations = 0;
+    double total_ns = 0;
+    double min_ns = 0;
+    auto wall_limit = bench_clock::now() + std::chrono::duration_cast<bench_clock::duration>(std::chrono::duration<double>(10 * min_time));
+    while (iterations < 3 || (total_ns < min_time * 1e9 && bench_clock::now() < wall_limit)) {
+        double ns = std::chrono::duration<double, std::nano>(op()).count();
+        min_ns = iterations == 0 ? ns : std::min(min_ns, ns);
+        total_ns += ns;
+        iterations++;
+    }
+    return { iterations, { total_ns / iterations, min_ns } };
+}
+
+template <typename F>
+static bench_clock::duration timed(F&& f) {
+    auto start = bench_clock::now();
+    f();
+    return bench_clock::now() - start;
+}
+
+static void run_size(const bench_config& cfg, int size, std::vector<bench_result>& results) {
+    synthetic_map map = make_map(cfg, size);
+    std::unique_ptr<game_board> board = game_board::generate_board(map.view, size, size, map.shell_data, map.tank_data);
+    size_t tanks = board->tanks.size();
+    size_t shells = board->shells.size();
+
+    auto record = [&](const std::string& name, const std::function<bench_clock::duration()>& op) {
+        auto [iterations, times] = measure(cfg.min_time, op);
+        results.push_back({ name, size, size, tanks, shells, iterations, times.first, times.second });
+        std::cerr << "  " << name << " " << size << "x" << size << ": " << times.first / 1e3 << " us\n";
+    };
+
+    record("generate_board", [&] {
+        std::unique_ptr<game_board> built; // Freed after the timed part
+        return timed([&] { built = game_board::generate_board(map.view, size, size, map.shell_data, map.tank_data); });
+    });
+    record("dummy_copy", [&] {
+        std::unique_ptr<game_board> copy;
+        return timed([&] { copy = board->dummy_copy(); });
+    });
+    record("symbol_copy", [&] {
+        std::unique_ptr<game_board> copy;
+        return timed([&] { copy = board->symbol_copy(); });
+    });
+    record("process_shells", [&] {
+        std::unique_ptr<game_board> copy = board->dummy_copy();
+        return timed([&] { copy->process_shells(); });
+    });
+    record("handle_cell_collisions", [&] {
+        std::unique_ptr<game_board> copy = board->dummy_copy();
+        copy->process_shells();
+        std::unordered_set<tank*> killed;
+        return timed([&] { copy->handle_cell_collisions(&killed); });
+    });
+    record("do_step", [&] {
+        std::unique_ptr<game_board> copy = board->dummy_copy();
+        std::unordered_set<tank*> killed;
+        return timed([&] { copy->do_step(&killed); });
+    });
+    record("updateCopy_full", [&] {
+        SatelliteViewImpl view;
+        return timed([&] { view.updateCopy(*board); });
+    });
+
+    // The per-round case: the view follows one board and only re-reads what a step changed
+    std::unique_ptr<game_board> tracked = board->dummy_copy();
+    SatelliteViewImpl tracked_view;
+    tracked_view.updateCopy(*tracked);
+    record("updateCopy_incremental", [&] {
+        if (tracked->shells.empty()) {
+            tracked = board->dummy_copy();
+            tracked_view.updateCopy(*tracked);
+        }
+        std::unordered_set<tank*> killed;
+        tracked->do_step(&killed);
+        return timed([&] { tracked_view.updateCopy(*tracked); });
+    });
+}
+
+static void write_csv(std::ostream& out, const std::vector<bench_result>& results) {
+    out << "benchmark,width,height,tanks,shells,iterations,mean_ns,min_ns\n";
+    for (const auto& r : results) {
+        out << r.name << ',' << r.width << ',' << r.height << ',' << r.tanks << ',' << r.shells << ','
+            << r.iterations << ',' << static_cast<long long>(r.mean_ns) << ',' << static_cast<long long>(r.min_ns) << '\n';
+    }
+}
+
+static void write_json(std::ostream& out, const bench_config& cfg, const std::vector<bench_result>& results) {
+    out << "{\n  \"config\": { \"wall_density\": " << cfg.wall_density
+        << ", \"mine_density\": " << cfg.mine_density
+        << ", \"tank_density\": " << cfg.tank_density
+        << ", \"shell_density\": " << cfg.shell_density
+        << ", \"seed\": " << cfg.seed << " },\n  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const auto& r = results[i];
+        out << "    { \"benchmark\": \"" << r.name << "\", \"width\": " << r.width << ", \"height\": " << r.height
+            << ", \"tanks\": " << r.tanks << ", \"shells\": " << r.shells << ", \"iterations\": " << r.iterations
+            << ", \"mean_ns\": " << static_cast<long long>(r.mean_ns) << ", \"min_ns\": " << static_cast<long long>(r.min_ns)
+            << " }" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+}
+
+static bool parse_args(int argc, char** argv, bench_config& cfg) {
+    std::map<std::string, std::string> args;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        size_t eq = arg.find('=');
+        if (eq == std::string::npos) {
+            std::cerr << "[ERROR] Expected key=value, got: " << arg << "\n";
+            return false;
+        }
+        args[arg.substr(0, eq)] = arg.substr(eq + 1);
+    }
+
+    try {
+        for (const auto& [key, value] : args) {
+            if (key == "sizes") {
+                cfg.sizes.clear();
+                std::stringstream list(value);
+                std::string item;
+                while (std::getline(list, item, ',')) cfg.sizes.push_back(std::stoi(item));
+            }
+            else if (key == "wall_density") cfg.wall_density = std::stod(value);
+            else if (key == "mine_density") cfg.mine_density = std::stod(value);
+            else if (key == "tank_density") cfg.tank_density = std::stod(value);
+            else if (key == "shell_density") cfg.shell_density = std::stod(value);
+            else if (key == "seed") cfg.seed = static_cast<uint32_t>(std::stoul(value));
+            else if (key == "min_time") cfg.min_time = std::stod(value);
+            else if (key == "format") cfg.format = value;
+            else if (key == "out") cfg.out = value;
+            else {
+                std::cerr << "[ERROR] Unknown argument: " << key << "\n";
+                return false;
+            }
+        }
+    } catch (const std::exception&) {
+        std::cerr << "[ERROR] Bad numeric argument\n";
+        return false;
+    }
+
+    if (cfg.format != "csv" && cfg.format != "json") {
+        std::cerr << "[ERROR] format must be csv or json\n";
+        return false;
+    }
+    for (int size : cfg.sizes) {
+        if (size < 1) {
+            std::cerr << "[ERROR] sizes must be positive\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    bench_config cfg;
+    if (!parse_args(argc, argv, cfg)) {
+        std::cerr << "Usage: engine_bench [sizes=10,100,1000] [wall_density=0.1] [mine_density=0.02] "
+                     "[tank_density=0.005] [shell_density=0.01] [seed=1] [min_time=0.2] [format=csv|json] [out=<file>]\n";
+        return 1;
+    }
+
+    std::vector<bench_result> results;
+    for (int size : cfg.sizes) {
+        std::cerr << "[BENCH] " << size << "x" << size << "\n";
+        run_size(cfg, size, results);
+    }
+
+    std::ofstream file;
+    if (!cfg.out.empty()) {
+        file.open(cfg.out);
+        if (!file) {
+            std::cerr << "[ERROR] Could not create " << cfg.out << "\n";
+            return 1;
+        }
+    }
+    std::ostream& out = cfg.out.empty() ? std::cout : file;
+    if (cfg.format == "json") write_json(out, cfg, results);
+    else write_csv(out, results);
+    return 0;
+}
@@ -0,0 +1,93 @@
+// Writes a random map in the simulator's map file format
+//
+//   ./map_generator [rows=100] [cols=100] [walls=0.1] [mines=0.02] [tanks1=5] [tanks2=5]
+//                   [symmetry=none|mirror|rotate] [border=1] [seed=1]
+//                   [max_steps=1000] [num_shells=20] [name=<description>] [out=<file>]
+//
+// The same arguments always give the same map, so generated maps can be regenerated instead of
+// checked in.
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include "map_generator.h"
+
+static bool parse_args(int argc, char** argv, map_params& params, std::string& out) {
+    std::map<std::string, std::string> args;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        size_t eq = arg.find('=');
+        if (eq == std::string::npos) {
+            std::cerr << "[ERROR] Expected key=value, got: " << arg << "\n";
+            return false;
+        }
+        args[arg.substr(0, eq)] = arg.substr(eq + 1);
+    }
+
+    try {
+        for (const auto& [key, value] : args) {
+            if (key == "rows") params.rows = std::stoi(value);
+            else if (key == "cols") params.cols = std::stoi(value);
+            else if (key == "walls") params.wall_density = std::stod(value);
+            else if (key == "mines") params.mine_density = std::stod(value);
+            else if (key == "tanks1") params.tanks1 = std::stoi(value);
+            else if (key == "tanks2") params.tanks2 = std::stoi(value);
+            else if (key == "border") params.border = std::stoi(value) != 0;
+            else if (key == "seed") params.seed = static_cast<uint32_t>(std::stoul(value));
+            else if (key == "max_steps") params.max_steps = std::stoi(value);
+            else if (key == "num_shells") params.num_shells = std::stoi(value);
+            else if (key == "name") params.name = value;
+            else if (key == "out") out = value;
+            else if (key == "symmetry") {
+                if (value == "none") params.symmetry = map_symmetry::none;
+                else if (value == "mirror") params.symmetry = map_symmetry::mirror;
+                else if (value == "rotate") params.symmetry = map_symmetry::rotate;
+                else {
+                    std::cerr << "[ERROR] symmetry must be none, mirror or rotate\n";
+                    return false;
+                }
+            }
+            else {
+                std::cerr << "[ERROR] Unknown argument: " << key << "\n";
+                return false;
+            }
+        }
+    } catch (const std::exception&) {
+        std::cerr << "[ERROR] Bad numeric argument\n";
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    map_params params;
+    std::string out;
+    if (!parse_args(argc, argv, params, out)) {
+        std::cerr << "Usage: map_generator [rows=100] [cols=100] [walls=0.1] [mines=0.02] [tanks1=5] [tanks2=5] "
+                     "[symmetry=none|mirror|rotate] [border=1] [seed=1] [max_steps=1000] [num_shells=20] "
+                     "[name=<description>] [out=<file>]\n";
+        return 1;
+    }
+
+    map_generator generator(params);
+    std::vector<std::string> grid;
+    try {
+        grid = generator.generate();
+    } catch (const std::exception& e) {
+        std::cerr << "[ERROR] " << e.what() << "\n";
+        return 1;
+    }
+
+    if (out.empty()) {
+        generator.write(std::cout, grid);
+        return 0;
+    }
+    std::ofstream file(out);
+    if (!file) {
+        std::cerr << "[ERROR] Could not create " << out << "\n";
+        return 1;
+    }
+    generator.write(file, grid);
+    return 0;
+}
@@ -0,0 +1,133 @@
+#ifndef MAP_GENERATOR_H
+#define MAP_GENERATOR_H
+
+#include <cstdint>
+#include <ostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+enum class map_symmetry {
+    none,   // Every cell drawn on its own
+    mirror, // Left half mirrored onto the right, player 2 mirrors player 1
+    rotate  // Point symmetric around the centre, player 2 is player 1 turned half way round
+};
+
+struct map_params {
+    int rows = 100;
+    int cols = 100;
+    double wall_density = 0.10;
+    double mine_density = 0.02;
+    int tanks1 = 5;
+    int tanks2 = 5;
+    map_symmetry symmetry = map_symmetry::none;
+    bool border = true; // Wall ring around the board, like the hand-written maps
+    uint32_t seed = 1;
+    int max_steps = 1000;
+    int num_shells = 20;
+    std::string name = "generated map";
+};
+
+// ==========
+// map_generator
+// ==========
+// Random maps in the simulator's map file format (see buildMapFromFile). Only the raw mt19937
+// output is used, not the standard distributions, so a seed gives the same map with every
+// compiler and standard library
+class map_generator {
+public:
+    explicit map_generator(const map_params& params) : params(params), rng(params.seed) {}
+
+    // Row strings, rows x cols of ' ', '#', '@', '1' and '2'. Throws when the tanks do not fit
+    std::vector<std::string> generate() {
+        const int rows = params.rows;
+        const int cols = params.cols;
+        if (rows < 1 || cols < 1) throw std::invalid_argument("rows and cols must be positive");
+        if (params.tanks1 < 0 || params.tanks2 < 0) throw std::invalid_argument("tank counts can not be negative");
+        if (params.symmetry != map_symmetry::none && params.tanks1 != params.tanks2) {
+            throw std::invalid_argument("symmetric maps need the same number of tanks per player");
+        }
+
+        std::vector<std::string> grid(rows, std::string(cols, ' '));
+
+        // Walls and mines are drawn once per symmetric pair of cells
+        for (int y = 0; y < rows; ++y) {
+            for (int x = 0; x < cols; ++x) {
+                auto [px, py] = partner(x, y);
+                if (index(px, py) < index(x, y)) continue;
+
+                char ch = ' ';
+                if (params.border && (x == 0 || y == 0 || x == cols - 1 || y == rows - 1)) ch = '#';
+                else if (chance(params.wall_density)) ch = '#';
+                else if (chance(params.mine_density)) ch = '@';
+                grid[y][x] = ch;
+                grid[py][px] = ch;
+            }
+        }
+
+        // Tank slots: empty cells whose partner is another cell, or any empty cell without symmetry
+        std::vector<std::pair<int, int>> slots;
+        for (int y = 0; y < rows; ++y) {
+            for (int x = 0; x < cols; ++x) {
+                auto [px, py] = partner(x, y);
+                bool canonical = params.symmetry == map_symmetry::none || index(x, y) < index(px, py);
+                if (canonical && grid[y][x] == ' ') slots.emplace_back(x, y);
+            }
+        }
+        size_t needed = params.symmetry == map_symmetry::none
+            ? static_cast<size_t>(params.tanks1) + params.tanks2
+            : static_cast<size_t>(params.tanks1);
+        if (slots.size() < needed) throw std::invalid_argument("not enough free cells for the tanks");
+
+        // Partial Fisher-Yates, the first slots become the tanks
+        for (size_t i = 0; i < needed; ++i) {
+            size_t j = i + rng() % (slots.size() - i);
+            std::swap(slots[i], slots[j]);
+        }
+        for (size_t i = 0; i < needed; ++i) {
+            auto [x, y] = slots[i];
+            if (params.symmetry == map_symmetry::none) {
+                grid[y][x] = i < static_cast<size_t>(params.tanks1) ? '1' : '2';
+            } else {
+                auto [px, py] = partner(x, y);
+                grid[y][x] = '1';
+                grid[py][px] = '2';
+            }
+        }
+        return grid;
+    }
+
+    // The map file: description, the four settings lines, then the rows
+    void write(std::ostream& out, const std::vector<std::string>& grid) const {
+        out << params.name << "\n";
+        out << "MaxSteps = " << params.max_steps << "\n";
+        out << "NumShells = " << params.num_shells << "\n";
+        out << "Rows = " << params.rows << "\n";
+        out << "Cols = " << params.cols << "\n";
+        for (const std::string& row : grid) {
+            out << row << "\n";
+        }
+    }
+
+private:
+    map_params params;
+    std::mt19937 rng;
+
+    int index(int x, int y) const { return y * params.cols + x; }
+
+    std::pair<int, int> partner(int x, int y) const {
+        switch (params.symmetry) {
+            case map_symmetry::mirror: return { params.cols - 1 - x, y };
+            case map_symmetry::rotate: return { params.cols - 1 - x, params.rows - 1 - y };
+            default: return { x, y };
+        }
+    }
+
+    bool chance(double p) {
+        return rng() < p * 4294967296.0; // mt19937 gives 32 uniform bits
+    }
+};
+
+#endif // MAP_GENERATOR_H
@@ -4,10 +4,27 @@
 #include <iostream>
 #include <stdexcept>
 #include <unordered_set>
+#include <cstring>
+#include <atomic>
 #include "GameObject.h"
 #include "../common/SatelliteView.h"
+#include "satellite_grid.h"
 #include "../common/SymbolObject.h"
 
+// splitmix64 finalizer; Zobrist keys are derived from it on the fly instead of
+// being stored in per-cell tables, so they are identical across processes
+static uint64_t mix64(uint64_t z) {
+    z += 0x9e3779b97f4a7c15ULL;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+static uint64_t next_static_version() {
+    static std::atomic<uint64_t> counter{0};
+    return ++counter;
+}
+
 // --------------------
 // cell methods
 // --------------------
@@ -26,15 +43,18 @@ game_object* cell::get_Object() {
 }
 
 void cell::add_Object(std::shared_ptr<game_object> obj) {
-    objects.push_back(obj);
+    objects.push_back(std::move(obj));
+    if (board) board->on_object_added(*this, objects.back().get());
 }
 
 void cell::remove_Object(game_object* obj) {
-    auto it = std::remove_if(objects.begin(), objects.end(),
+    auto it = std::find_if(objects.begin(), objects.end(),
         [obj](const std::shared_ptr<game_object>& ptr) {
             return ptr.get() == obj;
         });
-    objects.erase(it, objects.end());
+    if (it == objects.end()) return;
+    if (board) board->on_object_removed(*this, it - objects.begin());
+    objects.erase(it);
 }
 
 void cell::print() {
@@ -49,40 +69,413 @@ void cell::print() {
 }
 
 
+// --------------------
+// shell_slots methods
+// --------------------
+
+uint32_t shell_slots::claim(std::shared_ptr<shell> s) {
+    uint32_t idx;
+    if (free_slots.empty()) {
+        idx = static_cast<uint32_t>(slots.size());
+        slots.emplace_back();
+    } else {
+        idx = free_slots.back();
+        free_slots.pop_back();
+    }
+    s->slot = {idx, slots[idx].generation};
+    slots[idx].item = std::move(s);
+    count++;
+    return idx;
+}
+
+void shell_slots::link_after(uint32_t idx, uint32_t prev) {
+    uint32_t next = (prev == NIL) ? head : slots[prev].next;
+    slots[idx].prev = prev;
+    slots[idx].next = next;
+    if (prev == NIL) head = idx; else slots[prev].next = idx;
+    if (next == NIL) tail = idx; else slots[next].prev = idx;
+}
+
+void shell_slots::push_front(std::shared_ptr<shell> s) {
+    link_after(claim(std::move(s)), NIL);
+}
+
+void shell_slots::push_back(std::shared_ptr<shell> s) {
+    link_after(claim(std::move(s)), tail);
+}
+
+uint32_t shell_slots::erase(shell_handle h) {
+    slot& sl = slots[h.index];
+    uint32_t prev = sl.prev;
+    if (prev == NIL) head = sl.next; else slots[prev].next = sl.next;
+    if (sl.next == NIL) tail = prev; else slots[sl.next].prev = prev;
+    sl.item.reset();
+    sl.generation++;
+    free_slots.push_back(h.index);
+    count--;
+    return prev;
+}
+
+void shell_slots::pop_front() {
+    erase(slots[head].item->slot);
+}
+
+void shell_slots::restore(std::shared_ptr<shell> s, uint32_t prev) {
+    // Everything since the erase has been undone, so its slot is the last one freed
+    uint32_t idx = s->slot.index;
+    if (!free_slots.empty() && free_slots.back() == idx) {
+        free_slots.pop_back();
+    } else {
+        free_slots.erase(std::find(free_slots.begin(), free_slots.end(), idx));
+    }
+    slots[idx].generation = s->slot.generation;
+    slots[idx].item = std::move(s);
+    count++;
+    link_after(idx, prev);
+}
+
 // --------------------
 // game_board methods
 // --------------------
 
-game_board::game_board(int n, int m, std::vector<std::vector<cell>> arr)
-    : n(n), m(m), arr(std::move(arr)) {}
+game_board::game_board(int n, int m)
+    : n(n), m(m),
+      wall_hp(n * m, 0),
+      mine_layer(n * m, 0),
+      tank_count(n * m, 0),
+      shell_count(n * m, 0),
+      static_version(next_static_version()),
+      dirty_mark(n * m, 0) {
+    cells.reserve(n * m);
+    for (int j = 0; j < m; ++j) {
+        for (int i = 0; i < n; ++i) {
+            cells.emplace_back(i, j, this);
+        }
+    }
+}
 
-cell& game_board::get_cell(int x, int y) {
-    return arr[x][y];
+void game_board::add_to_layers(const cell& c, game_object* obj) {
+    int idx = index(c.x, c.y);
+    mark_dirty(idx);
+    switch (obj->get_kind()) {
+        case object_kind::tank:
+            tank_count[idx]++;
+            break;
+        case object_kind::shell:
+            shell_count[idx]++;
+            break;
+        case object_kind::wall:
+            wall_hp[idx] = static_cast<int8_t>(std::max(static_cast<wall*>(obj)->hp, 1));
+            static_version = next_static_version();
+            break;
+        case object_kind::mine:
+            mine_layer[idx] = 1;
+            static_version = next_static_version();
+            break;
+        default:
+            break;
+    }
+}
+
+void game_board::remove_from_layers(const cell& c, game_object* obj) {
+    int idx = index(c.x, c.y);
+    mark_dirty(idx);
+    switch (obj->get_kind()) {
+        case object_kind::tank:
+            tank_count[idx]--;
+            break;
+        case object_kind::shell:
+            shell_count[idx]--;
+            break;
+        case object_kind::wall:
+            wall_hp[idx] = 0;
+            static_version = next_static_version();
+            break;
+        case object_kind::mine:
+            mine_layer[idx] = 0;
+            static_version = next_static_version();
+            break;
+        default:
+            break;
+    }
+}
+
+void game_board::clear_dirty() {
+    for (int idx : dirty_cells) {
+        dirty_mark[idx] = 0;
+    }
+    dirty_cells.clear();
+}
+
+char game_board::glyph(int idx) const {
+    for (const auto& obj : cells[idx].objects) {
+        char ch = obj->get_symbol();
+        if (ch != ' ') return ch;
+    }
+    return ' ';
+}
+
+uint64_t game_board::object_key(const cell& c, const game_object* obj) const {
+    // Low bits: kind and symbol, then per-kind state; the cell index goes above bit 40
+    uint64_t f = static_cast<uint64_t>(obj->get_kind())
+               | static_cast<uint64_t>(static_cast<uint8_t>(obj->get_symbol())) << 3;
+    switch (obj->get_kind()) {
+        case object_kind::tank: {
+            const tank* t = static_cast<const tank*>(obj);
+            f |= static_cast<uint64_t>(t->dir) << 11;
+            f |= static_cast<uint64_t>(t->gear) << 15;
+            f |= static_cast<uint64_t>(t->shot_timer & 0xF) << 18;
+            f |= static_cast<uint64_t>(t->shells & 0xFFFF) << 22;
+            break;
+        }
+        case object_kind::shell: {
+            const shell* s = static_cast<const shell*>(obj);
+            f |= static_cast<uint64_t>(s->dir) << 11;
+            f |= static_cast<uint64_t>(s->just_created) << 15;
+            break;
+        }
+        case object_kind::wall:
+            f |= static_cast<uint64_t>(static_cast<const wall*>(obj)->hp & 0xFF) << 11;
+            break;
+        default:
+            break;
+    }
+    uint64_t key = mix64(static_cast<uint64_t>(index(c.x, c.y)) << 40 ^ f);
+    // A tank's key also depends on which tank it is, so two tanks of a player in the same state
+    // that trade cells change the hash. Mixed in again rather than XORed, a plain XOR of the id
+    // would cancel out over the swap
+    if (obj->get_kind() == object_kind::tank) {
+        key = mix64(key ^ obj->id);
+    }
+    return key;
+}
+
+uint64_t game_board::compute_hash() const {
+    uint64_t h = 0;
+    for (const cell& c : cells) {
+        for (const auto& obj : c.objects) {
+            h ^= object_key(c, obj.get());
+        }
+    }
+    return h;
+}
+
+void game_board::rehash(game_object* obj) {
+    if (obj->zobrist == 0) return; // Not on the board
+    zobrist_hash ^= obj->zobrist;
+    obj->zobrist = object_key(get_cell(obj->get_x(), obj->get_y()), obj);
+    zobrist_hash ^= obj->zobrist;
+}
+
+void game_board::on_object_added(cell& c, game_object* obj) {
+    add_to_layers(c, obj);
+    obj->zobrist = object_key(c, obj);
+    zobrist_hash ^= obj->zobrist;
+    if (open_moves > 0) {
+        undo_record r(undo_record::op::cell_add);
+        r.c = &c;
+        journal.push_back(std::move(r));
+    }
+}
+
+void game_board::on_object_removed(cell& c, size_t pos) {
+    game_object* obj = c.objects[pos].get();
+    remove_from_layers(c, obj);
+    if (open_moves > 0) {
+        undo_record r(undo_record::op::cell_remove);
+        r.c = &c;
+        r.index = static_cast<int>(pos);
+        r.obj = c.objects[pos];
+        r.key = obj->zobrist;
+        journal.push_back(std::move(r));
+    }
+    zobrist_hash ^= obj->zobrist;
+    obj->zobrist = 0;
+}
+
+void game_board::damage_wall(cell& c, wall* w) {
+    if (open_moves > 0) {
+        undo_record r(undo_record::op::wall_hp);
+        r.c = &c;
+        r.index = w->hp;
+        r.key = w->zobrist;
+        journal.push_back(std::move(r));
+    }
+    w->hp--;
+    if (w->hp <= 0) {
+        c.remove_Object(w);
+    } else {
+        wall_hp[index(c.x, c.y)] = static_cast<int8_t>(w->hp);
+        rehash(w);
+    }
+}
+
+void game_board::index_tank(tank* t) {
+    if (t->id >= tank_index.size()) {
+        tank_index.resize(t->id + 1, nullptr);
+    }
+    if (tank_index[t->id] && tank_index[t->id] != t) {
+        // find_tank would silently hand out the wrong tank from here on
+        throw std::runtime_error("Two tanks share entity id " + std::to_string(t->id));
+    }
+    tank_index[t->id] = t;
 }
 
 void game_board::add_tank(std::shared_ptr<tank> t) {
+    index_tank(t.get());
     tanks.push_back(std::move(t));
 }
 
 void game_board::remove_tank(game_object* t) {
-    if (tank* tk = dynamic_cast<tank*>(t)) {
-        tk->alive = false; 
+    if (t->get_kind() == object_kind::tank) {
+        static_cast<tank*>(t)->alive = false;
     }
 
-    tanks.erase(std::remove_if(tanks.begin(), tanks.end(),
-        [t](const std::shared_ptr<tank>& ptr) { return ptr.get() == t; }),
-        tanks.end());
+    auto it = std::find_if(tanks.begin(), tanks.end(),
+        [t](const std::shared_ptr<tank>& ptr) { return ptr.get() == t; });
+    if (it == tanks.end()) return;
+    if (open_moves > 0) {
+        undo_record r(undo_record::op::tank_erase);
+        r.index = static_cast<int>(it - tanks.begin());
+        r.obj = *it;
+        journal.push_back(std::move(r));
+    }
+    if (tank_index[t->id] == t) tank_index[t->id] = nullptr;
+    tanks.erase(it);
 }
 
 
 void game_board::add_shell(std::shared_ptr<shell> s) {
-    shells.insert(shells.begin(), std::move(s));
+    shells.push_front(std::move(s));
+    if (open_moves > 0) {
+        journal.push_back(undo_record(undo_record::op::shell_insert));
+    }
 }
 
 void game_board::remove_shell(game_object* s) {
-    shells.erase(std::remove_if(shells.begin(), shells.end(),
-        [s](const std::shared_ptr<shell>& ptr) { return ptr.get() == s; }),
-        shells.end());
+    if (s->get_kind() != object_kind::shell) return;
+    shell_handle h = static_cast<shell*>(s)->slot;
+    if (!shells.contains(h) || shells.get(h).get() != s) return;
+    std::shared_ptr<shell> owned = shells.get(h);
+    uint32_t prev = shells.erase(h);
+    if (open_moves > 0) {
+        undo_record r(undo_record::op::shell_erase);
+        r.index = static_cast<int>(prev);
+        r.obj = std::move(owned);
+        journal.push_back(std::move(r));
+    }
+}
+
+void game_board::journal_tank(tank* t) {
+    if (open_moves == 0) return;
+    undo_record r(undo_record::op::tank_state);
+    r.obj = t->shared_from_this();
+    r.c = t->curcell;
+    r.x = t->get_x();
+    r.y = t->get_y();
+    r.dir = t->dir;
+    r.shells = t->shells;
+    r.shot_timer = t->shot_timer;
+    r.alive = t->alive;
+    r.gear = t->gear;
+    r.key = t->zobrist;
+    journal.push_back(std::move(r));
+}
+
+void game_board::journal_shell(const std::shared_ptr<shell>& s) {
+    if (open_moves == 0) return;
+    undo_record r(undo_record::op::shell_state);
+    r.obj = s;
+    r.c = s->curcell;
+    r.x = s->get_x();
+    r.y = s->get_y();
+    r.just_created = s->just_created;
+    r.key = s->zobrist;
+    journal.push_back(std::move(r));
+}
+
+size_t game_board::begin_move() {
+    saved_collisions.push_back(collisions);
+    saved_hashes.push_back(zobrist_hash);
+    saved_static_versions.push_back(static_version);
+    open_moves++;
+    return journal.size();
+}
+
+size_t game_board::make_move(entity_id tank_id, ActionRequest action) {
+    size_t mark = begin_move();
+    simulate_step(tank_id, action);
+    return mark;
+}
+
+void game_board::unmake_move(size_t mark) {
+    while (journal.size() > mark) {
+        undo_record& r = journal.back();
+        switch (r.type) {
+            case undo_record::op::cell_add:
+                remove_from_layers(*r.c, r.c->objects.back().get());
+                r.c->objects.back()->zobrist = 0;
+                r.c->objects.pop_back();
+                break;
+            case undo_record::op::cell_remove:
+                r.c->objects.insert(r.c->objects.begin() + r.index, r.obj);
+                add_to_layers(*r.c, r.obj.get());
+                r.obj->zobrist = r.key;
+                break;
+            case undo_record::op::tank_erase:
+                tanks.insert(tanks.begin() + r.index, std::static_pointer_cast<tank>(r.obj));
+                index_tank(tanks[r.index].get());
+                break;
+            case undo_record::op::shell_insert:
+                shells.pop_front();
+                break;
+            case undo_record::op::shell_erase:
+                shells.restore(std::static_pointer_cast<shell>(r.obj), static_cast<uint32_t>(r.index));
+                break;
+            case undo_record::op::tank_state: {
+                tank* t = static_cast<tank*>(r.obj.get());
+                t->curcell = r.c;
+                t->set_x(r.x);
+                t->set_y(r.y);
+                t->dir = r.dir;
+                t->shells = r.shells;
+                t->shot_timer = r.shot_timer;
+                t->alive = r.alive;
+                t->gear = r.gear;
+                t->zobrist = r.key;
+                break;
+            }
+            case undo_record::op::shell_state: {
+                shell* s = static_cast<shell*>(r.obj.get());
+                s->curcell = r.c;
+                s->set_x(r.x);
+                s->set_y(r.y);
+                s->just_created = r.just_created;
+                s->zobrist = r.key;
+                break;
+            }
+            case undo_record::op::wall_hp:
+                // The wall itself is back in its cell, a cell_remove is undone before this
+                for (const auto& obj : r.c->objects) {
+                    if (obj->get_kind() == object_kind::wall) {
+                        static_cast<wall*>(obj.get())->hp = r.index;
+                        obj->zobrist = r.key;
+                    }
+                }
+                wall_hp[index(r.c->x, r.c->y)] = static_cast<int8_t>(r.index);
+                break;
+        }
+        journal.pop_back();
+    }
+
+    // Every hashed field is back to its old value, so the saved hash is exact again
+    zobrist_hash = saved_hashes.back();
+    saved_hashes.pop_back();
+    static_version = saved_static_versions.back();
+    saved_static_versions.pop_back();
+    collisions = std::move(saved_collisions.back());
+    saved_collisions.pop_back();
+    open_moves--;
 }
 
 void game_board::print_board() {
@@ -104,10 +497,10 @@ void game_board::print_board() {
 
 
 std::shared_ptr<shell> game_board::get_shared_shell(shell* s) {
-    for (auto& sp : shells) {
-        if (sp.get() == s) return sp;
+    if (!shells.contains(s->slot) || shells.get(s->slot).get() != s) {
+        throw std::runtime_error("Shell not found in board->shells");
     }
-    throw std::runtime_error("Shell not found in board->shells");
+    return shells.get(s->slot);
 }
 
 std::string game_board::get_board_state() {
@@ -117,9 +510,8 @@ std::string game_board::get_board_state() {
             if (get_cell(i, j).has_Object()) {
                 game_object* obj = get_cell(i, j).get_Object();
                 state += obj->get_symbol();
-                if (obj->get_symbol() == '#') {
-                    wall* w = dynamic_cast<wall*>(obj);
-                    state += std::to_string(w->hp);
+                if (obj->get_kind() == object_kind::wall) {
+                    state += std::to_string(static_cast<wall*>(obj)->hp);
                 }
             } else {
                 state += ' ';
@@ -130,7 +522,7 @@ std::string game_board::get_board_state() {
     for (const auto& t : tanks) {
         state += std::to_string(t->shot_timer);
         state += std::to_string(t->shells);
-        state += t->gear;
+        state += gear_name(t->gear);
     }
     for (const auto& s : shells) {
         state += std::to_string(s->just_created);
@@ -139,29 +531,18 @@ std::string game_board::get_board_state() {
 }
 
 std::unique_ptr<game_board> game_board::symbol_copy() const {
-    // Build empty board grid
-    std::vector<std::vector<cell>> arr_copy;
-    arr_copy.reserve(n);
-    for (int i = 0; i < n; ++i) {
-        std::vector<cell> row;
-        row.reserve(m);
-        for (int j = 0; j < m; ++j) {
-            row.emplace_back(i, j);
-        }
-        arr_copy.push_back(std::move(row));
-    }
-
-    auto new_board = std::make_unique<game_board>(n, m, std::move(arr_copy));
+    auto new_board = std::make_unique<game_board>(n, m);
 
     // Copy only symbols into SymbolObjects
     for (int i = 0; i < n; ++i) {
         for (int j = 0; j < m; ++j) {
-            const auto& src_cell = arr[i][j];
+            const auto& src_cell = get_cell(i, j);
             auto& dst_cell = new_board->get_cell(i, j);
 
             for (const auto& obj_ptr : src_cell.objects) {
                 char s = obj_ptr->get_symbol();
                 auto clone = std::make_shared<SymbolObject>(i, j, s);
+                clone->id = obj_ptr->id;
                 dst_cell.add_Object(clone);
             }
         }
@@ -171,57 +552,124 @@ std::unique_ptr<game_board> game_board::symbol_copy() const {
 }
 
 std::unique_ptr<game_board> game_board::dummy_copy() const {
-   std::vector<std::vector<cell>> arr_copy;
-    arr_copy.reserve(n);
-    for (int i = 0; i < n; ++i) {
-        std::vector<cell> row;
-        row.reserve(m);
-        for (int j = 0; j < m; ++j) {
-            row.emplace_back(i, j);  // row = i, col = j
-        }
-        arr_copy.push_back(std::move(row));
+    // Scratch state per thread, so copying does not allocate the snapshot every time
+    thread_local board_state scratch;
+    save_state(scratch);
+    return from_state(scratch);
+}
+
+// Position of obj among the objects of its cell, or -1 when the cell does not hold it
+static int depth_in(const cell* c, const game_object* obj) {
+    if (!c) return -1;
+    for (size_t i = 0; i < c->objects.size(); ++i) {
+        if (c->objects[i].get() == obj) return static_cast<int>(i);
     }
+    return -1;
+}
 
-    auto new_board = std::make_unique<game_board>(n, m, std::move(arr_copy));
+void game_board::save_state(board_state& out) const {
+    // Only objects actually on a cell make it into the state, like the cell scan used to do
+    size_t tank_count = std::count_if(tanks.begin(), tanks.end(),
+        [](const std::shared_ptr<tank>& t) { return depth_in(t->curcell, t.get()) >= 0; });
+    size_t shell_count = std::count_if(shells.begin(), shells.end(),
+        [](const std::shared_ptr<shell>& s) { return depth_in(s->curcell, s.get()) >= 0; });
+    out.reset(n, m, tank_count, shell_count);
+    out.set_hash(zobrist_hash);
 
-    for (int i = 0; i < n; ++i) {
-        for (int j = 0; j < m; ++j) {
-            const auto& src_cell = arr[i][j];
-            auto& dst_cell = new_board->get_cell(i, j);
+    tank_record* tr = out.tanks().data();
+    for (const auto& t : tanks) {
+        int depth = depth_in(t->curcell, t.get());
+        if (depth < 0) continue;
+        tank_record& r = *tr++;
+        r.x = t->get_x();
+        r.y = t->get_y();
+        r.cell = index(t->curcell->x, t->curcell->y);
+        r.shells = t->shells;
+        r.shot_timer = t->shot_timer;
+        r.player_number = t->player_number;
+        r.tank_number = t->tank_number;
+        r.dir = t->dir;
+        r.gear = t->gear;
+        r.alive = t->alive;
+        r.symbol = t->symbol;
+        r.depth = static_cast<uint16_t>(depth);
+    }
+    shell_record* sr = out.shells().data();
+    for (const auto& s : shells) {
+        int depth = depth_in(s->curcell, s.get());
+        if (depth < 0) continue;
+        shell_record& r = *sr++;
+        r.cell = index(s->curcell->x, s->curcell->y);
+        r.dir = s->dir;
+        r.just_created = s->just_created;
+        r.depth = static_cast<uint16_t>(depth);
+    }
 
-            for (const auto& obj_ptr : src_cell.objects) {
-                if (auto t = dynamic_cast<tank*>(obj_ptr.get())) {
-                    auto t_copy = std::make_shared<tank>(
-                        t->symbol, t->player_number, t->tank_number,
-                        t->directionx, t->directiony, &dst_cell, nullptr
-                    );
-                    t_copy->shells = t->shells;
-                    t_copy->shot_timer = t->shot_timer;
-                    t_copy->cannon_symbol = t->cannon_symbol;
-                    t_copy->gear = t->gear;
-                    t_copy->alive = t->alive;
-                    t_copy->set_x(t->get_x());
-                    t_copy->set_y(t->get_y());
-                    dst_cell.add_Object(t_copy);
-                    new_board->tanks.push_back(t_copy);
-                } else if (auto s = dynamic_cast<shell*>(obj_ptr.get())) {
-                    auto s_copy = std::make_shared<shell>(&dst_cell, s->directionx, s->directiony);
-                    s_copy->shell_symbol = "*"; 
-                    s_copy->just_created = s->just_created;
-                    dst_cell.add_Object(s_copy);
-                    new_board->shells.push_back(s_copy);
-                } else if (auto m = dynamic_cast<mine*>(obj_ptr.get())) {
-                    auto m_copy = std::make_shared<mine>(m->get_symbol(), &dst_cell);
-                    dst_cell.add_Object(m_copy);
-                } else if (auto w = dynamic_cast<wall*>(obj_ptr.get())) {
-                    auto w_copy = std::make_shared<wall>(w->get_symbol(), &dst_cell);
-                    w_copy->hp = w->hp;
-                    dst_cell.add_Object(w_copy);
-                }
-            }
+    std::memcpy(out.wall_hp(), wall_hp.data(), wall_hp.size());
+    std::memcpy(out.mines(), mine_layer.data(), mine_layer.size());
+    char* glyphs = out.glyphs();
+    for (size_t i = 0; i < cells.size(); ++i) {
+        glyphs[i] = glyph(static_cast<int>(i));
+    }
+}
+
+std::unique_ptr<game_board> game_board::from_state(const board_state& state) {
+    auto new_board = std::make_unique<game_board>(state.n(), state.m());
+    const int8_t* walls = state.wall_hp();
+    const uint8_t* mines = state.mines();
+
+    // Walls and mines never arrive after anything else, so they lead their cells
+    for (size_t i = 0; i < new_board->cells.size(); ++i) {
+        cell& c = new_board->cells[i];
+        if (walls[i] > 0) {
+            auto w = std::make_shared<wall>('#', &c);
+            w->hp = walls[i];
+            c.add_Object(std::move(w));
+        }
+        if (mines[i]) {
+            c.add_Object(std::make_shared<mine>('@', &c));
         }
     }
 
+    // Tanks and shells join the board in record order, which is the source's processing order,
+    // and their cells in the order they were stacked there
+    struct placement {
+        int cell;
+        int depth;
+        std::shared_ptr<game_object> obj;
+    };
+    std::vector<placement> placements;
+    placements.reserve(state.tanks().size() + state.shells().size());
+
+    for (const tank_record& r : state.tanks()) {
+        cell* c = &new_board->cells[r.cell];
+        auto t = std::make_shared<tank>(r.symbol, r.player_number, r.tank_number, 0, 0, c, nullptr);
+        t->dir = r.dir;
+        t->shells = r.shells;
+        t->shot_timer = r.shot_timer;
+        t->gear = r.gear;
+        t->alive = r.alive;
+        t->set_x(r.x);
+        t->set_y(r.y);
+        new_board->add_tank(t);
+        placements.push_back({ r.cell, r.depth, std::move(t) });
+    }
+    for (const shell_record& r : state.shells()) {
+        cell* c = &new_board->cells[r.cell];
+        auto s = std::make_shared<shell>(c, 0, 0);
+        s->dir = r.dir;
+        s->just_created = r.just_created;
+        new_board->shells.push_back(s);
+        placements.push_back({ r.cell, r.depth, std::move(s) });
+    }
+
+    std::stable_sort(placements.begin(), placements.end(), [](const placement& a, const placement& b) {
+        return a.cell != b.cell ? a.cell < b.cell : a.depth < b.depth;
+    });
+    for (auto& p : placements) {
+        new_board->cells[p.cell].add_Object(std::move(p.obj));
+    }
+
     return new_board;
 }
 
@@ -241,64 +689,52 @@ bool game_board::do_step(std::unordered_set<tank*>* recently_killed) {
 }
 
 void game_board::process_shells() {
-    std::vector<std::shared_ptr<shell>> shells_to_process = shells;
+    std::vector<std::shared_ptr<shell>> shells_to_process(shells.begin(), shells.end());
 
     for (auto& s : shells_to_process) {
         // Skip if this shell was already removed
-        if (std::find(shells.begin(), shells.end(), s) == shells.end())
+        if (!shells.contains(s->slot))
             continue;
 
+        journal_shell(s);
         s->shell_move_forward(*this);
         cell* c = s->curcell;
-
-        // Check for direct shell-shell overlap
-        int shell_count = 0;
-        for (const auto& obj : c->objects) {
-            if (dynamic_cast<shell*>(obj.get())) {
-                shell_count++;
-            }
-        }
+        int idx = index(c->x, c->y);
 
         // If multiple shells collide, remove them immediately
-        if (shell_count >= 2) {
-            for (auto it = c->objects.begin(); it != c->objects.end();) {
-                if (shell* sh = dynamic_cast<shell*>((*it).get())) {
-                    remove_shell(sh);
-                    it = c->objects.erase(it);
-                } else {
-                    ++it;
+        if (shell_count[idx] >= 2) {
+            std::vector<shell*> hit;
+            for (const auto& obj : c->objects) {
+                if (obj->get_kind() == object_kind::shell) {
+                    hit.push_back(static_cast<shell*>(obj.get()));
                 }
             }
+            for (shell* sh : hit) {
+                remove_shell(sh);
+                c->remove_Object(sh);
+            }
             continue;
         }
 
         // Check for wall collision
-        for (const auto& obj : c->objects) {
-            if (obj.get() == s.get()) continue;
-            if (wall* w = dynamic_cast<wall*>(obj.get())) {
-                w->hp--;
-                if (w->hp <= 0) {
-                    c->remove_Object(w);
+        if (wall_hp[idx] > 0) {
+            for (const auto& obj : c->objects) {
+                if (obj->get_kind() == object_kind::wall) {
+                    damage_wall(*c, static_cast<wall*>(obj.get()));
+                    break;
                 }
-                c->remove_Object(s.get());
-                remove_shell(s.get());
-                goto continue_loop;
             }
+            c->remove_Object(s.get());
+            remove_shell(s.get());
+            continue;
         }
 
         // Check for tank or other collision
-        for (const auto& obj : c->objects) {
-            if (obj.get() == s.get()) continue;
-            if (dynamic_cast<tank*>(obj.get()) || dynamic_cast<mine*>(obj.get())) {
-                if (std::find(collisions.begin(), collisions.end(), c) == collisions.end()) {
-                    collisions.push_back(c);
-                }
-                break;
+        if (tank_count[idx] > 0 || mine_layer[idx]) {
+            if (std::find(collisions.begin(), collisions.end(), c) == collisions.end()) {
+                collisions.push_back(c);
             }
         }
-
-    continue_loop:
-        continue;
     }
 }
 
@@ -306,47 +742,51 @@ void game_board::process_shells() {
 
 bool game_board::handle_cell_collisions(std::unordered_set<tank*>* recently_killed) {
     for (cell* c : collisions) {
-        std::vector<game_object*> tanks_to_remove;
+        std::vector<tank*> tanks_to_remove;
         std::vector<game_object*> shells_to_remove;
         std::vector<game_object*> mines_to_remove;
 
         for (const auto& ptr : c->objects) {
             game_object* obj = ptr.get();
-            if (dynamic_cast<tank*>(obj)) {
-                tanks_to_remove.push_back(obj);
-            } else if (dynamic_cast<shell*>(obj)) {
-                shells_to_remove.push_back(obj);
-            } else if (dynamic_cast<mine*>(obj)) {
-                mines_to_remove.push_back(obj);
+            switch (obj->get_kind()) {
+                case object_kind::tank:
+                    tanks_to_remove.push_back(static_cast<tank*>(obj));
+                    break;
+                case object_kind::shell:
+                    shells_to_remove.push_back(obj);
+                    break;
+                case object_kind::mine:
+                    mines_to_remove.push_back(obj);
+                    break;
+                default:
+                    break;
             }
         }
 
         // --- TANK VS TANK: destroy all tanks if more than one tank on the cell ---
         if (tanks_to_remove.size() > 1) {
-            for (game_object* t : tanks_to_remove) {
-                if (tank* tk = dynamic_cast<tank*>(t)) {
-                    if (tk->alive && recently_killed) {
-                        recently_killed->insert(tk);
-                    }
-                    tk->alive = false;
-                    remove_tank(tk);
-                    c->remove_Object(tk);
+            for (tank* tk : tanks_to_remove) {
+                journal_tank(tk);
+                if (tk->alive && recently_killed) {
+                    recently_killed->insert(tk);
                 }
+                tk->alive = false;
+                remove_tank(tk);
+                c->remove_Object(tk);
             }
         }
         // --- TANK VS SHELL or TANK VS MINE: destroy tanks if at least one tank and one shell or mine ---
         else if ((!shells_to_remove.empty() && !tanks_to_remove.empty()) ||
                  (!mines_to_remove.empty() && !tanks_to_remove.empty())) {
             // Destroy tanks
-            for (game_object* t : tanks_to_remove) {
-                if (tank* tk = dynamic_cast<tank*>(t)) {
-                    if (tk->alive && recently_killed) {
-                        recently_killed->insert(tk);
-                    }
-                    tk->alive = false;
-                    remove_tank(tk);
-                    c->remove_Object(tk);
+            for (tank* tk : tanks_to_remove) {
+                journal_tank(tk);
+                if (tk->alive && recently_killed) {
+                    recently_killed->insert(tk);
                 }
+                tk->alive = false;
+                remove_tank(tk);
+                c->remove_Object(tk);
             }
             // Destroy shells ONLY if a tank is present (tank vs shell)
             if (!shells_to_remove.empty() && !tanks_to_remove.empty()) {
@@ -389,25 +829,30 @@ std::unique_ptr<game_board> game_board::generate_board(
     int n,
     int m,
     const std::vector<std::tuple<int, int, int, int>>& shell_data,
-    const std::vector<std::tuple<int, int, int, int, std::string>>& tank_data
+    const std::vector<std::tuple<int, int, int, int, gear_state, int>>& tank_data
 ) {
-    std::vector<std::vector<cell>> arr;
-    arr.reserve(n);
-    for (int j = 0; j < n; ++j) {
-        std::vector<cell> col;
-        col.reserve(m);
-        for (int i = 0; i < m; ++i) {
-            col.emplace_back(j, i);
+    auto new_board = std::make_unique<game_board>(n, m);
+
+    std::vector<char> view_cells;
+    read_view_grid(view, n, m, view_cells);
+
+    // Tanks without a known number are numbered per player from above every number tank_data
+    // already hands out, so a fresh number never collides with a known one
+    std::vector<int> tank_counters(2, 0);
+    for (const auto& t : tank_data) {
+        int x = std::get<0>(t), y = std::get<1>(t), number = std::get<5>(t);
+        if (x < 0 || x >= n || y < 0 || y >= m || number < 0) continue;
+        char ch = view_cells[y * n + x];
+        if (ch == '1' || ch == '2') {
+            int& counter = tank_counters[ch == '1' ? 0 : 1];
+            counter = std::max(counter, number + 1);
         }
-        arr.push_back(std::move(col));
     }
-
-    auto new_board = std::make_unique<game_board>(n, m, std::move(arr));
-    std::vector<int> tank_counters(2, 0); // count tanks per player
+    std::vector<std::unordered_set<int>> numbers_taken(2);
 
     for (int i = 0; i < n; ++i) {
         for (int j = 0; j < m; ++j) {
-            char ch = view.getObjectAt(i, j);
+            char ch = view_cells[j * n + i];
             cell& current = new_board->get_cell(i, j);
 
             switch (ch) {
@@ -431,7 +876,6 @@ std::unique_ptr<game_board> game_board::generate_board(
                     }
 
                     auto s_ptr = std::make_shared<shell>(&current, dx, dy);
-                    s_ptr->shell_symbol = "*";
                     new_board->shells.push_back(s_ptr);
                     current.add_Object(std::move(s_ptr));
                     break;
@@ -439,7 +883,6 @@ std::unique_ptr<game_board> game_board::generate_board(
                 case '1':
                 case '2': {
                     int player_index = (ch == '1') ? 0 : 1;
-                    int tank_number = ++tank_counters[player_index];
 
                     // Find matching tank data
                     auto it = std::find_if(tank_data.begin(), tank_data.end(),
@@ -448,13 +891,23 @@ std::unique_ptr<game_board> game_board::generate_board(
                         });
 
                     int dx = (player_index == 0 ? -1 : 1), dy = 0;
-                    std::string gear = "forward";
+                    gear_state gear = gear_state::forward;
+                    int tank_number = -1;
 
                     if (it != tank_data.end()) {
                         dx = std::get<2>(*it);
                         dy = std::get<3>(*it);
                         gear = std::get<4>(*it);
+                        tank_number = std::get<5>(*it);
+                    }
+
+                    // Unknown tanks are numbered in scan order, on a first view from 0 like the
+                    // game manager does, so their entity ids agree with the real board. A number
+                    // already given to another tank of the player is replaced the same way
+                    if (tank_number < 0 || numbers_taken[player_index].count(tank_number)) {
+                        tank_number = tank_counters[player_index]++;
                     }
+                    numbers_taken[player_index].insert(tank_number);
 
                     auto t_ptr = std::make_shared<tank>(
                         ch, player_index + 1, tank_number,
@@ -463,7 +916,7 @@ std::unique_ptr<game_board> game_board::generate_board(
                     t_ptr->set_x(i);
                     t_ptr->set_y(j);
                     t_ptr->gear = gear;
-                    new_board->tanks.push_back(t_ptr);
+                    new_board->add_tank(t_ptr);
                     current.add_Object(t_ptr);
                     break;
                 }
@@ -476,26 +929,22 @@ std::unique_ptr<game_board> game_board::generate_board(
     return new_board;
 }
 
-void game_board::simulate_step(const std::tuple<int, int, std::string>& tank_command) {
-    int x, y;
-    std::string action;
-    std::tie(x, y, action) = tank_command;
-
-    // Find the tank at (x, y)
-    tank* target_tank = nullptr;
-    for (auto& t_ptr : tanks) {
-        tank* t = t_ptr.get();
-        if (t->get_x() == x && t->get_y() == y) {
-            target_tank = t;
-            break;
-        }
-    }
-
-    // Simulate the action for the target tank
+void game_board::simulate_step(entity_id tank_id, ActionRequest action) {
+    // Simulate the action for the tank, unless it is no longer on the board
+    tank* target_tank = find_tank(tank_id);
     if (target_tank) {
-        target_tank->turn(this, action);
+        turn_tank(target_tank, action);
     }
 
+    finish_step();
+}
+
+void game_board::turn_tank(tank* t, ActionRequest action) {
+    journal_tank(t);
+    t->apply(this, action);
+}
+
+void game_board::finish_step() {
     // Advance the board state
     std::unordered_set<tank*> dummy_recently_killed;
     do_step(&dummy_recently_killed);
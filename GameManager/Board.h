@@ -3,10 +3,14 @@
 
 #include <memory>
 #include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <iterator>
 #include <iostream>
 #include <algorithm>
 #include <string>
 #include "GameObject.h"
+#include "board_state.h"
 #include <unordered_set>
 #include "../common/SatelliteView.h"
 
@@ -20,6 +24,7 @@ class tank;
 class shell;
 class mine;
 class wall;
+class game_board;
 
 // ==========
 // cell
@@ -28,10 +33,12 @@ class cell {
 public:
     int x, y;
     std::vector<std::shared_ptr<game_object>> objects;
+    game_board* board; // Owning board, keeps its occupancy layers in sync (may be null)
 
-    cell() : x(0), y(0) {}
-    cell(int x, int y) : x(x), y(y) {}
-    cell(int x, int y, std::shared_ptr<game_object> obj) : x(x), y(y) {
+    cell() : x(0), y(0), board(nullptr) {}
+    cell(int x, int y) : x(x), y(y), board(nullptr) {}
+    cell(int x, int y, game_board* board) : x(x), y(y), board(board) {}
+    cell(int x, int y, std::shared_ptr<game_object> obj) : x(x), y(y), board(nullptr) {
         objects.push_back(std::move(obj));
     }
 
@@ -40,13 +47,14 @@ public:
     cell& operator=(const cell&) = delete;
 
     cell(cell&& other) noexcept
-        : x(other.x), y(other.y), objects(std::move(other.objects)) {}
+        : x(other.x), y(other.y), objects(std::move(other.objects)), board(other.board) {}
 
     cell& operator=(cell&& other) noexcept {
         if (this != &other) {
             x = other.x;
             y = other.y;
             objects = std::move(other.objects);
+            board = other.board;
         }
         return *this;
     }
@@ -62,6 +70,110 @@ public:
     void print();
 };
 
+// ==========
+// undo_record
+// ==========
+// One reversible board mutation, journaled while a move is open (see game_board::make_move)
+struct undo_record {
+    enum class op : uint8_t {
+        cell_add,     // Object appended to c->objects
+        cell_remove,  // Object erased from c->objects at index
+        tank_erase,   // Tank erased from tanks at index
+        shell_insert, // Shell inserted at the front of shells
+        shell_erase,  // Shell erased from shells, index is the slot it followed
+        tank_state,   // Tank fields before turn() or being killed
+        shell_state,  // Shell fields before shell_move_forward()
+        wall_hp       // Wall hp before damage
+    };
+
+    op type;
+    int index = 0;     // Vector position, or the old hp for wall_hp
+    cell* c = nullptr;
+    std::shared_ptr<game_object> obj;
+    uint64_t key = 0;  // Object's Zobrist key before the change
+
+    // Saved object fields for the *_state and wall_hp records
+    int x = 0, y = 0;
+    direction dir = 0;
+    int shells = 0;
+    int shot_timer = 0;
+    bool alive = false;
+    bool just_created = false;
+    gear_state gear = gear_state::forward;
+
+    explicit undo_record(op type) : type(type) {}
+};
+
+// ==========
+// shell_slots
+// ==========
+// Generational slot map holding a board's shells. Slots are linked in processing order
+// (newest shell first), so add, remove and lookup by handle are O(1) while iteration
+// order stays what the old front-inserted vector gave
+class shell_slots {
+public:
+    static constexpr uint32_t NIL = UINT32_MAX;
+
+    class iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::shared_ptr<shell>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const std::shared_ptr<shell>*;
+        using reference = const std::shared_ptr<shell>&;
+
+        iterator() : owner(nullptr), at(NIL) {}
+        iterator(const shell_slots* owner, uint32_t at) : owner(owner), at(at) {}
+        const std::shared_ptr<shell>& operator*() const { return owner->slots[at].item; }
+        pointer operator->() const { return &owner->slots[at].item; }
+        iterator& operator++() { at = owner->slots[at].next; return *this; }
+        iterator operator++(int) { iterator old = *this; ++*this; return old; }
+        bool operator==(const iterator& other) const { return at == other.at; }
+        bool operator!=(const iterator& other) const { return at != other.at; }
+
+    private:
+        const shell_slots* owner;
+        uint32_t at;
+    };
+
+    iterator begin() const { return iterator(this, head); }
+    iterator end() const { return iterator(this, NIL); }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    void push_front(std::shared_ptr<shell> s);
+    void push_back(std::shared_ptr<shell> s);
+
+    bool contains(shell_handle h) const {
+        return h.index < slots.size() && slots[h.index].item && slots[h.index].generation == h.generation;
+    }
+    const std::shared_ptr<shell>& get(shell_handle h) const { return slots[h.index].item; }
+
+    // Unlinks the shell and returns the slot it followed (NIL at the front)
+    uint32_t erase(shell_handle h);
+
+    // Exact inverses of push_front and erase, valid when undone in reverse order
+    void pop_front();
+    void restore(std::shared_ptr<shell> s, uint32_t prev);
+
+private:
+    struct slot {
+        std::shared_ptr<shell> item; // Null while the slot is free
+        uint32_t generation = 0;
+        uint32_t prev = NIL;
+        uint32_t next = NIL;
+    };
+
+    std::vector<slot> slots;
+    std::vector<uint32_t> free_slots; // Reused last-in first-out
+    uint32_t head = NIL;
+    uint32_t tail = NIL;
+    size_t count = 0;
+
+    uint32_t claim(std::shared_ptr<shell> s);
+    void link_after(uint32_t idx, uint32_t prev);
+};
+
 // ==========
 // game_board
 // ==========
@@ -70,31 +182,112 @@ public:
     int n;
     int m;
     std::vector<std::shared_ptr<tank>> tanks;
-    std::vector<std::shared_ptr<shell>> shells;
-    std::vector<std::vector<cell>> arr;
+    std::vector<tank*> tank_index; // By entity_id, kept by add_tank/remove_tank
+    shell_slots shells;
     std::vector<cell*> collisions;
 
-    game_board(int n, int m, std::vector<std::vector<cell>> arr);
+    // Flat row-major grid, cell (x, y) lives at index y * n + x
+    std::vector<cell> cells;
+
+    // Occupancy layers, parallel to cells and maintained by cell::add_Object/remove_Object
+    std::vector<int8_t> wall_hp;       // 0 when the cell has no wall
+    std::vector<uint8_t> mine_layer;   // 1 when the cell holds a mine
+    std::vector<uint8_t> tank_count;   // Tanks currently on the cell
+    std::vector<uint8_t> shell_count;  // Shells currently on the cell
+
+    // Changes whenever a wall or mine is added or removed, unique across all boards,
+    // so caches derived from the static layer can tell when to rebuild
+    uint64_t static_version;
+
+    // Cells whose objects changed since the last clear_dirty(), only recorded while
+    // track_dirty is set (by a SatelliteViewImpl patching its grid from this board)
+    bool track_dirty = false;
+    std::vector<int> dirty_cells;
+    std::vector<uint8_t> dirty_mark; // Parallel to cells, 1 while the cell is in dirty_cells
+
+    void mark_dirty(int idx) {
+        if (track_dirty && !dirty_mark[idx]) {
+            dirty_mark[idx] = 1;
+            dirty_cells.push_back(idx);
+        }
+    }
+    void clear_dirty();
+
+    game_board(int n, int m);
+
+    // Cells point back to their board, so a board can not be copied or moved
+    game_board(const game_board&) = delete;
+    game_board& operator=(const game_board&) = delete;
 
-    cell& get_cell(int x, int y);
+    int index(int x, int y) const { return y * n + x; }
+    cell& get_cell(int x, int y) { return cells[index(x, y)]; }
+    const cell& get_cell(int x, int y) const { return cells[index(x, y)]; }
+
+    bool has_wall(int x, int y) const { return wall_hp[index(x, y)] > 0; }
+    bool has_mine(int x, int y) const { return mine_layer[index(x, y)] != 0; }
+    int tanks_at(int x, int y) const { return tank_count[index(x, y)]; }
+    int shells_at(int x, int y) const { return shell_count[index(x, y)]; }
+
+    // What a SatelliteView shows for the cell: the first non-blank symbol on it, or ' '
+    char glyph(int idx) const;
+
+    // Undo journal for in-place search, only recorded while open_moves > 0
+    std::vector<undo_record> journal;
+    std::vector<std::vector<cell*>> saved_collisions;
+    std::vector<uint64_t> saved_hashes;
+    std::vector<uint64_t> saved_static_versions;
+    int open_moves = 0;
+
+    // Incremental Zobrist hash of everything on the board, see object_key()
+    uint64_t zobrist_hash = 0;
+
+    uint64_t hash() const { return zobrist_hash; }
+    uint64_t compute_hash() const;
+    uint64_t object_key(const cell& c, const game_object* obj) const;
+    void rehash(game_object* obj);
+
+    void add_to_layers(const cell& c, game_object* obj);
+    void remove_from_layers(const cell& c, game_object* obj);
+    void on_object_added(cell& c, game_object* obj);
+    void on_object_removed(cell& c, size_t pos);
+    void damage_wall(cell& c, wall* w);
+
+    // Make/unmake: mutations between begin_move() and unmake_move() are reverted exactly
+    size_t begin_move();
+    size_t make_move(entity_id tank_id, ActionRequest action);
+    void unmake_move(size_t mark);
+    void journal_tank(tank* t);
+    void journal_shell(const std::shared_ptr<shell>& s);
 
     void add_tank(std::shared_ptr<tank> t);
     void remove_tank(game_object* t);
+    tank* find_tank(entity_id id) const { return id < tank_index.size() ? tank_index[id] : nullptr; }
+    void index_tank(tank* t);
 
     void add_shell(std::shared_ptr<shell> s);
     std::shared_ptr<shell> get_shared_shell(shell* s);
     void remove_shell(game_object* s);
 
+    // tank_data holds x, y, direction, gear and tank number per tank, a number of -1 lets
+    // generate_board number the tank itself
     static std::unique_ptr<game_board> generate_board(
     SatelliteView &view,
     int n, int m,
     const std::vector<std::tuple<int, int, int, int>>& shell_data,
-    const std::vector<std::tuple<int, int, int, int, std::string>>& tank_data
+    const std::vector<std::tuple<int, int, int, int, gear_state, int>>& tank_data
     );
-    void simulate_step(const std::tuple<int, int, std::string>& tank_command);
+    void simulate_step(entity_id tank_id, ActionRequest action);
+
+    // simulate_step in parts, so a search can let several tanks act within one step
+    void turn_tank(tank* t, ActionRequest action);
+    void finish_step();
     
     void print_board();
     std::unique_ptr<game_board> dummy_copy() const;
+
+    // Flat snapshot of the board and the way back, from_state(save_state(b)) is a dummy_copy of b
+    void save_state(board_state& out) const;
+    static std::unique_ptr<game_board> from_state(const board_state& state);
     std::unique_ptr<game_board> symbol_copy() const;
     int countAliveTanksForPlayer(char symbol) const;
     std::string get_board_state();
@@ -104,10 +297,6 @@ public:
     void process_shells();
     bool handle_cell_collisions(std::unordered_set<tank*>* recently_killed);
 
-    void simulate_step(
-        const std::tuple<int, int, std::string>& tank_action
-    ) const;
-
     void destroy_all_objects();
 };
 
@@ -8,6 +8,7 @@
 #include "../common/TankAlgorithm.h"         // Fix include path
 #include "../common/Player.h"                // Fix include path
 #include "../common/ActionUtils.h"
+#include <atomic>
 #include <fstream>
 #include <iostream>
 #include <sstream>
@@ -25,6 +26,9 @@ namespace IDs_329506620_206055055 {
 GameManager::GameManager(bool verbose)
     : verboseOutput(verbose) {
     satview = std::make_unique<SatelliteViewImpl>();
+    timingsDir = phase_timers::sidecar_dir_from_env();
+    budget = action_budget::from_env();
+    timers.enable(!timingsDir.empty() || budget.enabled());
     if (verboseOutput) {
         std::string outName = "output_verbose.txt";
         verboseFile.open(outName);
@@ -45,16 +49,14 @@ GameResult GameManager::run(
     MyTankAlgorithmFactory player1_tank_algo_factory,
     MyTankAlgorithmFactory player2_tank_algo_factory
 ) {
-    (void)name1;
-    (void)name2;
+    timers.reset();
     std::vector<int> tank_counters(3, 0);
     if (DEBUG_ENABLED) {
         std::cout << "[DEBUG] Building board from SatelliteView...\n";
     }
 
 // Prepare cells
-std::vector<std::vector<cell>> arr;
-arr.reserve(map_width);
+board = std::make_unique<game_board>((int)map_width, (int)map_height);
 
 // Temporary storage for tanks + algos
 std::vector<std::shared_ptr<tank>> tempTanks;
@@ -62,17 +64,15 @@ std::vector<std::unique_ptr<TankAlgorithm>> tempAlgos;
 
 // Build grid from SatelliteView
 for (size_t i = 0; i < map_width; ++i) {
-    std::vector<cell> row;
-    row.reserve(map_height);
     for (size_t j = 0; j < map_height; ++j) {
-        row.emplace_back((int)i, (int)j);
+        cell& current = board->get_cell((int)i, (int)j);
         char c = map.getObjectAt(i, j);
 
         if (c == '#') {
-            row.back().add_Object(std::make_shared<wall>('#', &row.back()));
+            current.add_Object(std::make_shared<wall>('#', &current));
         }
         else if (c == '@') {
-            row.back().add_Object(std::make_shared<mine>('@', &row.back()));
+            current.add_Object(std::make_shared<mine>('@', &current));
         }
        else if (c == '1' || c == '2') {
     int player_idx = (c == '1' ? 1 : 2);   // 1 for Player1, 2 for Player2
@@ -82,8 +82,8 @@ for (size_t i = 0; i < map_width; ++i) {
 
     // Tanks use player_number = 1/2 (NOT 0/1), just like Task 2
     auto t = std::make_shared<tank>(c, player_idx, tank_number,
-                                    directionx, 0, &row.back(), nullptr);
-    row.back().add_Object(t);
+                                    directionx, 0, &current, nullptr);
+    current.add_Object(t);
     tempTanks.push_back(t);
 
     // Algorithms always created with 0/1 indices (NOT 1/2)
@@ -104,15 +104,11 @@ for (size_t i = 0; i < map_width; ++i) {
 }
 
     }
-    arr.push_back(std::move(row));
 }
 
-// Create the board
-board = std::make_unique<game_board>((int)map_width, (int)map_height, std::move(arr));
-
 // Move tanks/algorithms into GameManager's storage
 for (auto& t : tempTanks) {
-    board->tanks.push_back(t);
+    board->add_tank(t);
 }
 for (auto& algo : tempAlgos) {
     tankAlgorithms.push_back(std::move(algo));
@@ -154,6 +150,9 @@ if (satview) {
         return a->get_y() < b->get_y();
     });
 
+    // Tanks that lost their turns for the rest of the game under budget_policy::forfeit
+    std::vector<bool> forfeited(tanks_by_birth.size(), false);
+
     std::unordered_set<tank*> killed_tanks;
     int round_counter = 0;
     std::unordered_set<tank*> recently_killed;
@@ -169,6 +168,7 @@ if (satview) {
         }
         satelliteCopyReady = false;
 
+        auto phase_start = timers.start();
         bool out_of_shells = true;
         for (const auto& t_ptr : board->tanks) {
             tank* t = t_ptr.get();
@@ -186,28 +186,38 @@ if (satview) {
         }
 
         for (tank* t : tanks_by_birth) {
-            if (t->shot_timer > 0) t->shot_timer--;
+            if (t->shot_timer > 0) {
+                t->shot_timer--;
+                board->rehash(t);
+            }
         }
+        timers.stop(game_phase::shot_timers, phase_start);
 
         std::vector<ActionRequest> move_enums(tanks_by_birth.size(), ActionRequest::DoNothing);
-        std::vector<std::string> moves(tanks_by_birth.size());
         std::vector<bool> turn_success(tanks_by_birth.size(), false);
 
         // Ask each alive tank for move
         for (size_t i = 0; i < tanks_by_birth.size(); ++i) {
             tank* t = tanks_by_birth[i];
-            if (t->alive) {
+            if (t->alive && forfeited[i]) {
+                move_enums[i] = ActionRequest::DoNothing;
+            } else if (t->alive) {
+                phase_start = timers.start();
                 ActionRequest action = t->algo->getAction();
+                uint64_t elapsed = timers.stop(game_phase::get_action, phase_start);
+                timers.record_call(game_phase::get_action, t->player_number, elapsed);
+                if (overBudget(t, "getAction", elapsed, round_counter)) {
+                    if (budget.policy != budget_policy::log) action = ActionRequest::DoNothing;
+                    if (budget.policy == budget_policy::forfeit) forfeited[i] = true;
+                }
                 move_enums[i] = action;
-                moves[i] = actionToString(action);
                 turn_success[i] = true;
                 if (DEBUG_ENABLED) {
                     std::cout << "[DEBUG] Tank P" << t->player_number 
                               << " T" << t->tank_number 
-                              << " chose: " << moves[i] << "\n";
+                              << " chose: " << actionToString(action) << "\n";
                 }
             } else {
-                moves[i] = "killed";
                 move_enums[i] = ActionRequest::DoNothing;
                 if (DEBUG_ENABLED) {
                     std::cout << "[DEBUG] Tank P" << t->player_number 
@@ -220,11 +230,13 @@ if (satview) {
         for (size_t i = 0; i < tanks_by_birth.size(); ++i) {
             tank* t = tanks_by_birth[i];
             if (t->alive) {
-                if (moves[i] == "update") {
+                if (move_enums[i] == ActionRequest::GetBattleInfo) {
+                    phase_start = timers.start();
                     if (!satelliteCopyReady) {
                         static_cast<SatelliteViewImpl*>(satview.get())->updateCopy(*board);
                         satelliteCopyReady = true;
                     }
+                    auto call_start = timers.start();
                   if (t->player_number == 1) {
                     player1.updateTankWithBattleInfo(*t->algo, *satview);
                 } else if (t->player_number == 2) {
@@ -232,16 +244,25 @@ if (satview) {
                 } else {
                     throw std::runtime_error("Invalid player_number for tank");
                 }
+                uint64_t call_elapsed = timers.elapsed_since(call_start);
+                timers.stop(game_phase::battle_info, phase_start);
+                timers.record_call(game_phase::battle_info, t->player_number, call_elapsed);
+                // The battle info is already delivered, only forfeit has anything left to take
+                if (overBudget(t, "updateTankWithBattleInfo", call_elapsed, round_counter) &&
+                    budget.policy == budget_policy::forfeit) {
+                    forfeited[i] = true;
+                }
                 continue;
                 }
-                bool ok = t->turn(board.get(), moves[i]);
+                phase_start = timers.start();
+                bool ok = t->apply(board.get(), move_enums[i]);
+                timers.stop(game_phase::apply, phase_start);
                 if (!ok) {
-                    moves[i] += " (ignored)";
                     turn_success[i] = false;
                     if (DEBUG_ENABLED) {
                         std::cout << "[DEBUG] Tank P" << t->player_number 
                                   << " T" << t->tank_number 
-                                  << " invalid move: " << moves[i] << "\n";
+                                  << " invalid move: " << actionToString(move_enums[i]) << "\n";
                     }
                 }
             }
@@ -249,16 +270,19 @@ if (satview) {
 
         // Handle collisions and steps
         recently_killed.clear();
+        phase_start = timers.start();
         game_over = board->handle_cell_collisions(&recently_killed);
+        timers.stop(game_phase::collisions, phase_start);
         if (!game_over) {
+            phase_start = timers.start();
             game_over = board->do_step(&recently_killed);
+            timers.stop(game_phase::step, phase_start);
         }
 
         // Mark killed tanks
         for (size_t i = 0; i < tanks_by_birth.size(); ++i) {
             tank* t = tanks_by_birth[i];
             if (recently_killed.count(t)) {
-                moves[i] += " (killed)";
                 killed_tanks.insert(t);
                 if (DEBUG_ENABLED) {
                     std::cout << "[DEBUG] Tank P" << t->player_number 
@@ -301,6 +325,10 @@ if (satview) {
         result.gameState = std::move(satview);
     }
 
+    if (!timingsDir.empty()) {
+        writeTimings(map_name, name1, name2, result.rounds);
+    }
+
     if (DEBUG_ENABLED) {
         std::cout << "[DEBUG] Game finished after " << result.rounds 
                   << " rounds | Winner=" << result.winner 
@@ -314,6 +342,48 @@ if (satview) {
     return result;
 }
 
+// Logs a call that took longer than the budget; the caller applies the policy
+bool GameManager::overBudget(const tank* t, const char* call, uint64_t elapsed_ns, size_t round) {
+    if (!budget.exceeded(elapsed_ns)) return false;
+    timers.record_overrun(t->player_number);
+    std::cerr << "[BUDGET] Round " << (round + 1) << ": P" << t->player_number
+              << " T" << t->tank_number << " " << call << " took " << elapsed_ns / 1000
+              << " us, budget " << budget.limit_ns / 1000 << " us ("
+              << action_budget::policy_name(budget.policy) << ")" << std::endl;
+    return true;
+}
+
+// Latencies of every game this process ran, per algorithm, rewritten after each game
+static latency_summary all_games_latency;
+
+// Sidecar named after the map and both algorithms, with a per-process game number so repeated
+// runs of the same pairing do not overwrite each other
+void GameManager::writeTimings(const std::string& map_name, const std::string& name1,
+                               const std::string& name2, size_t rounds) const {
+    static std::atomic<unsigned> game_counter{0};
+    namespace fs = std::filesystem;
+    std::ostringstream file_name;
+    file_name << "timings_" << fs::path(map_name).stem().string()
+              << "_" << fs::path(name1).stem().string()
+              << "_" << fs::path(name2).stem().string()
+              << "_" << game_counter++ << ".json";
+
+    fs::path path = fs::path(timingsDir) / file_name.str();
+    std::ofstream out(path);
+    if (!out.is_open()) {
+        std::cerr << "[ERROR] could not write timings to " << path.string() << std::endl;
+        return;
+    }
+    timers.write_json(out, map_name, name1, name2, rounds);
+
+    all_games_latency.add(name1, timers.player_latency(1));
+    all_games_latency.add(name2, timers.player_latency(2));
+    fs::path summary = fs::path(timingsDir) / "latency_summary.json";
+    if (!all_games_latency.write_file(summary.string())) {
+        std::cerr << "[ERROR] could not write latency summary to " << summary.string() << std::endl;
+    }
+}
+
 std::string GameManager::commandStringToEnumName(const std::string& cmd) {
     if (cmd.find("fw") == 0) return "MoveForward";
     if (cmd.find("bw") == 0) return "MoveBackward";
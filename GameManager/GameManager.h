@@ -8,6 +8,8 @@
 #include "../common/PlayerFactory.h"
 #include "../common/SatelliteView.h"
 #include "SatelliteViewImpl.h"
+#include "phase_timers.h"
+#include "action_budget.h"
 #include "../common/AbstractGameManager.h"
 #include "../common/GameResult.h"
 #include "../common/ActionRequest.h"
@@ -43,6 +45,13 @@ private:
 
     bool verboseOutput = false;
     std::ofstream verboseFile;
+
+    phase_timers timers;
+    std::string timingsDir; // Where run() writes the timing sidecar, empty when timing is off
+    action_budget budget;
+    bool overBudget(const tank* t, const char* call, uint64_t elapsed_ns, size_t round);
+    void writeTimings(const std::string& map_name, const std::string& name1,
+                      const std::string& name2, size_t rounds) const;
 };
 
 } // namespace IDs_329506620_206055055
@@ -11,15 +11,33 @@ using namespace std;
 #define M_PI 3.14159265358979323846
 #endif
 
+// Refresh an object's Zobrist key after one of its hashed fields changed in place
+static void rehash_on_board(cell* c, game_object* obj) {
+    if (c && c->board) c->board->rehash(obj);
+}
+
+const char* gear_name(gear_state gear) {
+    switch (gear) {
+        case gear_state::forward: return "forward";
+        case gear_state::middle: return "middle";
+        case gear_state::backwards_move: return "backwards move";
+        case gear_state::backward: return "backward";
+    }
+    return "forward";
+}
+
 // --------------------
 // game_object
 // --------------------
 
 game_object::game_object(int x, int y, char symbol)
-    : x(x), y(y), symbol(symbol) {}
+    : x(x), y(y), symbol(symbol), kind(object_kind::symbol) {}
 
 game_object::game_object()
-    : x(0), y(0), symbol(' ') {}
+    : x(0), y(0), symbol(' '), kind(object_kind::symbol) {}
+
+game_object::game_object(object_kind kind)
+    : x(0), y(0), symbol(' '), kind(kind) {}
 
 char game_object::get_symbol() const {
     return symbol;
@@ -37,11 +55,11 @@ void game_object::set_y(int y) {
     this->y = y;
 }
 
-int game_object::get_x() {
+int game_object::get_x() const {
     return x;
 }
 
-int game_object::get_y() {
+int game_object::get_y() const {
     return y;
 }
 
@@ -50,10 +68,10 @@ int game_object::get_y() {
 // --------------------
 
 shell::shell(cell* curcell, int directionx, int directiony)
-    : directionx(directionx), directiony(directiony), curcell(curcell), just_created(true) {
+    : game_object(object_kind::shell),
+      dir(direction_of(directionx, directiony)), just_created(true), curcell(curcell) {
     x = curcell->get_X();
     y = curcell->get_Y();
-    set_shell_symbol();
 }
 
 char shell::get_symbol() const{
@@ -64,8 +82,8 @@ void shell::shell_move_forward(game_board& board) {
     curcell->remove_Object(this);
 
     // Move forward
-    x = (x + directionx + board.n) % board.n;
-    y = (y + directiony + board.m) % board.m;
+    x = (x + dx() + board.n) % board.n;
+    y = (y + dy() + board.m) % board.m;
 
     curcell = &board.get_cell(x, y);
     curcell->add_Object(board.get_shared_shell(this));
@@ -73,6 +91,7 @@ void shell::shell_move_forward(game_board& board) {
     // If it's just been created, don't trigger collision yet
     if (just_created) {
         just_created = false;
+        board.rehash(this);
         return;
     }
 
@@ -81,8 +100,9 @@ void shell::shell_move_forward(game_board& board) {
         std::find(board.collisions.begin(), board.collisions.end(), curcell) == board.collisions.end()) {
         for (const auto& ptr : curcell->objects) {
             game_object* obj = ptr.get();
-            if ((obj->get_symbol() == '#' || obj->get_symbol() == '1' || obj->get_symbol() == '2' ||
-                 (dynamic_cast<shell*>(obj) && obj != this))) {
+            object_kind k = obj->get_kind();
+            if (k == object_kind::wall || k == object_kind::tank ||
+                (k == object_kind::shell && obj != this)) {
                 board.collisions.push_back(curcell);
                 break;
             }
@@ -90,19 +110,8 @@ void shell::shell_move_forward(game_board& board) {
     }
 }
 
-void shell::set_shell_symbol() {
-    if (directionx == 1 && directiony == 0) shell_symbol = "→";
-    else if (directionx == 0 && directiony == -1) shell_symbol = "↑";
-    else if (directionx == -1 && directiony == 0) shell_symbol = "←";
-    else if (directionx == 0 && directiony == 1) shell_symbol = "↓";
-    else if (directionx == 1 && directiony == -1) shell_symbol = "↗";
-    else if (directionx == -1 && directiony == -1) shell_symbol = "↖";
-    else if (directionx == -1 && directiony == 1) shell_symbol = "↙";
-    else if (directionx == 1 && directiony == 1) shell_symbol = "↘";
-}
-
 string shell::to_string() {
-    return "[ " + shell_symbol + "]";
+    return std::string("[ ") + DIR_GLYPH[dir] + "]";
 }
 
 // --------------------
@@ -110,30 +119,29 @@ string shell::to_string() {
 // --------------------
 
 tank::tank(char symbol, int player_number, int tank_number, int directionx, int directiony, cell* curcell, TankAlgorithm* algo)
-    : shells(16),
+    : game_object(object_kind::tank),
+      shells(16),
       player_number(player_number),
       tank_number(tank_number),
-      directionx(directionx),
-      directiony(directiony),
       shot_timer(0),
       symbol(symbol),
-      cannon_symbol(""),
-      gear("forward"),
+      dir(direction_of(directionx, directiony)),
+      gear(gear_state::forward),
       curcell(curcell),
       algo(algo),
       alive(true)
 {
+    id = tank_entity_id(player_number, tank_number);
     x = curcell->get_X();
     y = curcell->get_Y();
-    set_cannon_symbol();
 }
 char tank::get_symbol() const {
     return symbol; // or whatever field you use for the tank's symbol
 }
 void tank::move_forward(game_board& board) {
     curcell->remove_Object(this);
-    x = (x + directionx + board.n) % board.n;
-    y = (y + directiony + board.m) % board.m;
+    x = (x + dx() + board.n) % board.n;
+    y = (y + dy() + board.m) % board.m;
     curcell = &board.get_cell(x, y);
     curcell->add_Object(shared_from_this());
 
@@ -143,9 +151,9 @@ void tank::move_forward(game_board& board) {
 }
 
 void tank::move_backwards(game_board& board) {
-    int new_x = (x - directionx + board.n) % board.n;
-    int new_y = (y - directiony + board.m) % board.m;
-    cell* newcell = &board.arr[new_x][new_y];
+    int new_x = (x - dx() + board.n) % board.n;
+    int new_y = (y - dy() + board.m) % board.m;
+    cell* newcell = &board.get_cell(new_x, new_y);
 
     // Allow moving if the cell is empty or does not have a wall
     if (!newcell->has_Object() || newcell->get_Object()->get_symbol() != 'w') {
@@ -163,104 +171,96 @@ void tank::move_backwards(game_board& board) {
 }
 
 
-void tank::rotate_4(string direction) {
-    auto new_dir = ::rotate_4(directionx, directiony, direction);
-    directionx = new_dir.first;
-    directiony = new_dir.second;
-    set_cannon_symbol();
+void tank::rotate_4(rotation side) {
+    dir = ::rotate_4(dir, side);
+    rehash_on_board(curcell, this);
+}
+
+void tank::rotate_8(rotation side) {
+    dir = ::rotate_8(dir, side);
+    rehash_on_board(curcell, this);
 }
 
-void tank::rotate_8(string direction) {
-    auto new_dir = ::rotate_8(directionx, directiony, direction);
-    directionx = new_dir.first;
-    directiony = new_dir.second;
-    set_cannon_symbol();
+void tank::set_gear(gear_state new_gear) {
+    if (gear == new_gear) return;
+    gear = new_gear;
+    rehash_on_board(curcell, this);
 }
 
 void tank::shoot(game_board* board) {
     if (shells > 0) {
         shells--;
         shot_timer = 4;
+        board->rehash(this);
         cell* curcell = &board->get_cell(x, y);
 
-        auto s = std::make_shared<shell>(curcell, directionx, directiony);
+        auto s = std::make_shared<shell>(curcell, dx(), dy());
         curcell->add_Object(s);
         board->add_shell(s);  // Add shell to the board's shell list
     }
 }
 
 
-bool tank::turn(game_board* board, const string& move) {
-    if (gear == "forward") {
-        if (move == "skip") return true;
-        if (move == "bw") { gear = "middle"; return true; }
-        return handle_move(board, move);
-    } else if (gear == "middle") {
-        if (move == "fw") { gear = "forward"; return true; }
-        gear = "backwards move"; return true;
-    } else if (gear == "backwards move") {
-        move_backwards(*board);
-        gear = "backward";
-        return true;
-    } else if (gear == "backward") {
-        if (move == "skip") return true;
-        if (move == "bw") { move_backwards(*board); return true; }
-        gear = "forward";
-        return handle_move(board, move);
+bool tank::apply(game_board* board, ActionRequest action) {
+    switch (gear) {
+        case gear_state::forward:
+            if (action == ActionRequest::DoNothing) return true;
+            if (action == ActionRequest::MoveBackward) { set_gear(gear_state::middle); return true; }
+            return handle_move(board, action);
+        case gear_state::middle:
+            if (action == ActionRequest::MoveForward) { set_gear(gear_state::forward); return true; }
+            set_gear(gear_state::backwards_move); return true;
+        case gear_state::backwards_move:
+            move_backwards(*board);
+            set_gear(gear_state::backward);
+            return true;
+        case gear_state::backward:
+            if (action == ActionRequest::DoNothing) return true;
+            if (action == ActionRequest::MoveBackward) { move_backwards(*board); return true; }
+            set_gear(gear_state::forward);
+            return handle_move(board, action);
     }
 
     return false;
 }
 
-bool tank::handle_move(game_board* board, const string& move) {
-    if (move == "fw") {
-        if (wall_coll_check(&board->arr[(x + directionx + board->n) % board->n][(y + directiony + board->m) % board->m]))
-            return false;
-        move_forward(*board);
-        gear = "forward";
-        return true;
-    } else if (move == "r4l") { rotate_4("left"); gear = "forward"; return true; }
-    else if (move == "r8l") { rotate_8("left"); gear = "forward"; return true; }
-    else if (move == "r4r") { rotate_4("right"); gear = "forward"; return true; }
-    else if (move == "r8r") { rotate_8("right"); gear = "forward"; return true; }
-    else if (move == "shoot") {
-        if (shot_timer == 0) {
-            shoot(board);
-            gear = "forward";
+bool tank::handle_move(game_board* board, ActionRequest action) {
+    switch (action) {
+        case ActionRequest::MoveForward:
+            if (wall_coll_check(&board->get_cell((x + dx() + board->n) % board->n, (y + dy() + board->m) % board->m)))
+                return false;
+            move_forward(*board);
+            set_gear(gear_state::forward);
             return true;
-        }
-        return false;
+        case ActionRequest::RotateLeft90: rotate_4(rotation::left); set_gear(gear_state::forward); return true;
+        case ActionRequest::RotateLeft45: rotate_8(rotation::left); set_gear(gear_state::forward); return true;
+        case ActionRequest::RotateRight90: rotate_4(rotation::right); set_gear(gear_state::forward); return true;
+        case ActionRequest::RotateRight45: rotate_8(rotation::right); set_gear(gear_state::forward); return true;
+        case ActionRequest::Shoot:
+            if (shot_timer == 0) {
+                shoot(board);
+                set_gear(gear_state::forward);
+                return true;
+            }
+            return false;
+        default:
+            return false;
     }
-
-    return false;
 }
 
 bool tank::wall_coll_check(cell* dest) {
-    if (dest->has_Object()) {
-        return dest->get_Object()->get_symbol() == '#';
+    if (dest->board->has_wall(dest->x, dest->y)) {
+        return true;
+    }
+    // Boards from game_board::symbol_copy hold walls as plain '#' symbols, outside the wall layer
+    for (const auto& obj : dest->objects) {
+        if (obj->get_symbol() == '#') return true;
     }
     return false;
 }
 
-void tank::set_cannon_symbol() {
-    double degree = atan2(-directiony, directionx) * (180.0 / M_PI);
-    if (degree < 0) degree += 360;
-    if (degree == 0) cannon_symbol = "→";
-    else if (degree == 90) cannon_symbol = "↑";
-    else if (degree == 180) cannon_symbol = "←";
-    else if (degree == 270) cannon_symbol = "↓";
-    else if (degree == 45) cannon_symbol = "↗";
-    else if (degree == 135) cannon_symbol = "↖";
-    else if (degree == 225) cannon_symbol = "↙";
-    else if (degree == 315) cannon_symbol = "↘";
-}
-
-string tank::get_cannon_symbol() {
-    return cannon_symbol;
-}
-
 string tank::to_string() {
-    return "[" + (symbol + cannon_symbol) + "]";
+    return "[" + (symbol + std::string(DIR_GLYPH[dir])) + "]";
 }
 
 // --------------------
@@ -268,7 +268,7 @@ string tank::to_string() {
 // --------------------
 
 mine::mine(char symbol, cell* curcell)
-    : curcell(curcell) {
+    : game_object(object_kind::mine), curcell(curcell) {
     this->symbol = symbol;
     x = curcell->get_X();
     y = curcell->get_Y();
@@ -283,7 +283,7 @@ string mine::to_string() {
 // --------------------
 
 wall::wall(char symbol, cell* curcell)
-    : hp(2), curcell(curcell) {
+    : game_object(object_kind::wall), hp(2), curcell(curcell) {
     this->symbol = symbol;
     x = curcell->get_X();
     y = curcell->get_Y();
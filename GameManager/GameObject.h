@@ -6,12 +6,49 @@
 #include <string>
 #include <cmath>
 #include <memory>
+#include <cstdint>
+#include "../common/ActionRequest.h"
+#include "direction.h"
 
 // Forward declarations
 class game_board;
 class cell;
 class TankAlgorithm;
 
+// Concrete type of a game_object, checked instead of dynamic_cast in the step loop
+enum class object_kind : uint8_t {
+    symbol, // Plain SymbolObject, carries no game state
+    tank,
+    shell,
+    mine,
+    wall
+};
+
+// Tank gear. A backward move is requested in forward gear, waits a turn in middle and is
+// carried out in backwards_move; backward then keeps moving back on every request
+enum class gear_state : uint8_t {
+    forward,
+    middle,
+    backwards_move,
+    backward
+};
+
+// Gear name for logs and the board state string
+const char* gear_name(gear_state gear);
+
+enum class rotation : uint8_t {
+    left,
+    right
+};
+
+// Identifies a tank on every copy of a board, the game manager's and the players' alike
+using entity_id = uint32_t;
+constexpr entity_id NO_ENTITY = 0; // Objects that are not tanks
+
+constexpr entity_id tank_entity_id(int player_number, int tank_number) {
+    return static_cast<entity_id>(tank_number) << 4 | static_cast<entity_id>(player_number & 0xF);
+}
+
 // ========================
 // Base Class: game_object
 // ========================
@@ -20,18 +57,25 @@ protected:
     int x;
     int y;
     char symbol;
+    object_kind kind;
 
 public:
+    uint64_t zobrist = 0; // Key currently folded into the board hash, 0 while off the board
+    entity_id id = NO_ENTITY;
+
     game_object();
+    explicit game_object(object_kind kind);
     game_object(int x, int y, char symbol);
     virtual char get_symbol() const;
     virtual ~game_object() = default;
 
+    object_kind get_kind() const { return kind; }
+
     void set_symbol(char s);
     void set_x(int x);
     void set_y(int y);
-    [[nodiscard]] int get_x();
-    [[nodiscard]] int get_y();
+    [[nodiscard]] int get_x() const;
+    [[nodiscard]] int get_y() const;
 
     virtual std::string to_string() = 0;
 
@@ -40,22 +84,28 @@ public:
     }
 };
 
+// Stable reference to a shell in its board's shell_slots, stale once the shell is removed
+struct shell_handle {
+    uint32_t index = UINT32_MAX;
+    uint32_t generation = 0;
+};
+
 // ==========
 // shell
 // ==========
 class shell : public game_object {
 public:
-    int directionx;
-    int directiony;
-    cell* curcell;
-    std::string shell_symbol;
+    direction dir;
     bool just_created;
+    cell* curcell;
+    shell_handle slot; // Set by shell_slots while the shell is on a board
 
 
     shell(cell* curcell, int directionx, int directiony);
     char get_symbol() const override;
+    int dx() const { return DIR_DX[dir]; }
+    int dy() const { return DIR_DY[dir]; }
     void shell_move_forward(game_board& board);
-    void set_shell_symbol();
     std::string to_string() override;
 };
 
@@ -67,27 +117,27 @@ public:
     int shells;
     int player_number; // 0 or 1
     int tank_number;   // per-player index
-    int directionx;
-    int directiony;
     int shot_timer;
     char symbol;
-    std::string cannon_symbol;
-    std::string gear;
+    direction dir;
+    gear_state gear;
     cell* curcell;
     TankAlgorithm* algo;  // Not owned
     bool alive;
 
     tank(char symbol, int player_number, int tank_number, int directionx, int directiony, cell* curcell, TankAlgorithm* algo);
     char get_symbol() const override;
+    int dx() const { return DIR_DX[dir]; }
+    int dy() const { return DIR_DY[dir]; }
     void move_forward(game_board& board);
     void move_backwards(game_board& board);
-    void rotate_4(std::string direction);
-    void rotate_8(std::string direction);
+    void rotate_4(rotation side);
+    void rotate_8(rotation side);
+    void set_gear(gear_state new_gear);
     void shoot(game_board* board);
-    [[nodiscard]] std::string get_cannon_symbol();
-    void set_cannon_symbol();
-    bool turn(game_board* board, const std::string& move);
-    bool handle_move(game_board* board, const std::string& move);
+    [[nodiscard]] const char* get_cannon_symbol() const { return DIR_GLYPH[dir]; }
+    bool apply(game_board* board, ActionRequest action);
+    bool handle_move(game_board* board, ActionRequest action);
     bool wall_coll_check(cell* dest);
     std::string to_string() override;
 };
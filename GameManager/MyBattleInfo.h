@@ -5,6 +5,7 @@
 #include <vector>
 #include "Vector2D.h"
 #include "Board.h"
+#include "board_state.h"
 #include "SatelliteViewImpl.h"
 
 using namespace std;
@@ -12,22 +13,22 @@ using namespace std;
 class MyBattleInfo : public BattleInfo
 {
 private:
-    tuple<int, int, int, int, string> selfTank; // x, y, direction_x, direction_y, gear
-    unique_ptr<game_board> board;
+    tuple<int, int, int, int, gear_state> selfTank; // x, y, direction_x, direction_y, gear
+    board_snapshot state; // The player's view of the board, shared with the player and its other tanks
 
 public:
-    MyBattleInfo(unique_ptr<game_board> board) : board(std::move(board)) {}
+    MyBattleInfo(board_snapshot state) : state(std::move(state)) {}
     virtual ~MyBattleInfo() = default;
 
-    game_board *getBoard() const {
-        return board.get();
+    const board_snapshot& getState() const {
+        return state;
     }
 
-    tuple<int, int, int, int, string> getSelfTank() const {
+    tuple<int, int, int, int, gear_state> getSelfTank() const {
         return selfTank;
     }
 
-    void setSelfTank(tuple<int, int, int, int, string> t) {
+    void setSelfTank(tuple<int, int, int, int, gear_state> t) {
         selfTank = t;
     }
 };
@@ -1,47 +1,69 @@
 #include "SatelliteViewImpl.h"
 #include <memory>
+#include <atomic>
 
 
 // Debug control - set to true to enable debugging, false to disable
 bool DEBUG_SAT = false;
 
-void SatelliteViewImpl::updateCopy(const game_board& original) {
-    boardCopy = original.dummy_copy();  // just assign, no extra wrapper
+static uint64_t next_view_version() {
+    static std::atomic<uint64_t> counter{0};
+    return ++counter;
+}
+
+void SatelliteViewImpl::rebuild(const game_board& original) {
+    width = original.n;
+    height = original.m;
+    grid.resize(static_cast<size_t>(width) * height);
+    for (size_t i = 0; i < grid.size(); ++i) {
+        grid[i] = original.glyph(static_cast<int>(i));
+    }
+    source = nullptr;
+}
+
+void SatelliteViewImpl::updateCopy(game_board& original) {
+    if (source == &original && original.track_dirty) {
+        for (int idx : original.dirty_cells) {
+            grid[idx] = original.glyph(idx);
+        }
+        if (DEBUG_SAT) {
+            std::cout << "[DEBUG] SatelliteView patched " << original.dirty_cells.size() << " cells\n";
+        }
+    } else {
+        rebuild(original);
+        original.track_dirty = true;
+        source = &original;
+    }
+    original.clear_dirty();
+    version = next_view_version();
 }
 
 void SatelliteViewImpl::updateSymbols(const game_board& original) {
-    boardCopy = original.symbol_copy();
+    rebuild(original);
+    version = next_view_version();
     if (DEBUG_SAT) {
-        std::cout << "[DEBUG] SatelliteView updated with symbol_copy()\n";
+        std::cout << "[DEBUG] SatelliteView rebuilt from the board\n";
     }
 }
 
 char SatelliteViewImpl::getObjectAt(size_t x, size_t y) const {
-    if (!boardCopy || x >= static_cast<size_t>(boardCopy->n) || y >= static_cast<size_t>(boardCopy->m)) {
+    if (x >= static_cast<size_t>(width) || y >= static_cast<size_t>(height)) {
         if (DEBUG_SAT) std::cout << "[DEBUG] SatView out of bounds (" << x << "," << y << ")\n";
         return '&';
     }
 
-    const cell& c = boardCopy->get_cell(x, y);
+    char ch = grid[y * width + x];
     if (DEBUG_SAT) {
-        std::cout << "[DEBUG] SatView (" << x << "," << y << ") objects=" << c.objects.size() << "\n";
+        std::cout << "[DEBUG] SatView (" << x << "," << y << ") -> '" << ch << "'\n";
     }
-
-    if (c.objects.empty()) {
-        return ' ';
-    }
-
-    for (const std::shared_ptr<game_object>& obj : c.objects) {
-        char ch = obj->get_symbol();
-        if (DEBUG_SAT) {
-            std::cout << "[DEBUG]   -> obj.get_symbol() returned '" << ch << "'\n";
-        }
-        if (ch != ' ') return ch;
-    }
-
-    return ' ';
+    return ch;
 }
 
 void SatelliteViewImpl::print_board() const {
-    if (boardCopy) boardCopy->print_board();
+    for (int j = 0; j < height; ++j) {
+        for (int i = 0; i < width; ++i) {
+            std::cout << "[ " << grid[j * width + i] << "]";
+        }
+        std::cout << std::endl;
+    }
 }
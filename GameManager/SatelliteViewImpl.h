@@ -2,19 +2,40 @@
 #define SATELLITE_VIEW_IMPL_H
 
 #include "SatelliteView.h"
+#include "satellite_grid.h"
 #include "Board.h"
 #include <memory>
 #include <cstddef>
+#include <cstdint>
+#include <vector>
 
-class SatelliteViewImpl : public SatelliteView {
+// ==========
+// SatelliteViewImpl
+// ==========
+// What every cell of a board shows, kept as a flat row-major char grid. The first update
+// reads the whole board and asks it to track dirty cells, later updates from the same board
+// only re-read the cells that changed since
+class SatelliteViewImpl : public SatelliteView, public satellite_grid {
 private:
-    std::unique_ptr<game_board> boardCopy;
+    int width = 0;
+    int height = 0;
+    std::vector<char> grid; // Cell (x, y) at y * width + x
+    uint64_t version = 0;   // New on every update, unique across views
+    const game_board* source = nullptr; // Board whose dirty cells the grid follows
+
+    void rebuild(const game_board& original);
 
 public:
-    const game_board* getBoardCopy() const { return boardCopy.get();}
-    void updateCopy(const game_board& original);
+    // Changes whenever the view is updated, equal versions mean the same contents
+    uint64_t getVersion() const { return version; }
+    void updateCopy(game_board& original);
      void updateSymbols(const game_board& original); 
     char getObjectAt(size_t x, size_t y) const override;
+
+    const char* grid_data() const override { return grid.empty() ? nullptr : grid.data(); }
+    size_t grid_width() const override { return static_cast<size_t>(width); }
+    size_t grid_height() const override { return static_cast<size_t>(height); }
+
     void print_board() const;
 };
 
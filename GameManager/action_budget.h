@@ -0,0 +1,60 @@
+#ifndef ACTION_BUDGET_H
+#define ACTION_BUDGET_H
+
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+// What happens to a tank whose algorithm overran its budget
+enum class budget_policy {
+    log,     // Only report the overrun, the action stands
+    skip,    // The overrunning getAction counts as DoNothing
+    forfeit  // As skip, and the tank does nothing for the rest of the game without being asked
+};
+
+// ==========
+// action_budget
+// ==========
+// Optional wall time limit for a single getAction or updateTankWithBattleInfo call. The calls
+// are synchronous, so an overrun can not be cut short; it is caught afterwards and handled by
+// the policy. Configured through TANKS_ACTION_BUDGET_US (microseconds, 0 or unset for no
+// budget) and TANKS_BUDGET_POLICY (log, skip or forfeit, skip by default)
+struct action_budget {
+    uint64_t limit_ns = 0;
+    budget_policy policy = budget_policy::skip;
+
+    bool enabled() const { return limit_ns > 0; }
+    bool exceeded(uint64_t elapsed_ns) const { return enabled() && elapsed_ns > limit_ns; }
+
+    static const char* policy_name(budget_policy p) {
+        switch (p) {
+            case budget_policy::log: return "log";
+            case budget_policy::skip: return "skip";
+            default: return "forfeit";
+        }
+    }
+
+    static action_budget from_env() {
+        action_budget budget;
+        if (const char* limit = std::getenv("TANKS_ACTION_BUDGET_US")) {
+            char* end = nullptr;
+            unsigned long long us = std::strtoull(limit, &end, 10);
+            if (end == limit || *end != '\0') {
+                std::cerr << "[ERROR] TANKS_ACTION_BUDGET_US must be a number of microseconds, ignoring it" << std::endl;
+            } else {
+                budget.limit_ns = static_cast<uint64_t>(us) * 1000;
+            }
+        }
+        if (const char* policy = std::getenv("TANKS_BUDGET_POLICY")) {
+            std::string name = policy;
+            if (name == "log") budget.policy = budget_policy::log;
+            else if (name == "skip") budget.policy = budget_policy::skip;
+            else if (name == "forfeit") budget.policy = budget_policy::forfeit;
+            else std::cerr << "[ERROR] TANKS_BUDGET_POLICY must be log, skip or forfeit, using skip" << std::endl;
+        }
+        return budget;
+    }
+};
+
+#endif // ACTION_BUDGET_H
@@ -0,0 +1,154 @@
+#ifndef BOARD_STATE_H
+#define BOARD_STATE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <vector>
+#include "GameObject.h"
+
+// Flat, pointer-free records of the objects on a board, see board_state
+struct tank_record {
+    int32_t x, y;          // The tank's own position, players may move it without moving cells
+    int32_t cell;          // Index of the cell holding the tank
+    int32_t shells;
+    int32_t shot_timer;
+    int32_t player_number;
+    int32_t tank_number;
+    direction dir;
+    gear_state gear;
+    bool alive;
+    char symbol;
+    uint16_t depth;        // Position among the cell's objects
+};
+
+struct shell_record {
+    int32_t cell;
+    direction dir;
+    bool just_created;
+    uint16_t depth;
+};
+
+struct board_state_header {
+    int32_t n, m;
+    uint32_t tank_count;
+    uint32_t shell_count;
+    uint64_t hash;         // Zobrist hash of the board the state was taken from
+};
+
+static_assert(std::is_trivially_copyable_v<tank_record>, "tank_record must stay memcpy-able");
+static_assert(std::is_trivially_copyable_v<shell_record>, "shell_record must stay memcpy-able");
+static_assert(std::is_trivially_copyable_v<board_state_header>, "board_state_header must stay memcpy-able");
+
+// ==========
+// board_state
+// ==========
+// Everything a game_board holds, laid out in one contiguous buffer: the header, the tank and
+// shell records in board order, then the wall hp, mine and glyph layers of n * m cells each.
+// Copying a state is a single memcpy into a buffer that only grows, so a state kept around
+// and refilled every round stops allocating after the first one (see game_board::save_state
+// and game_board::from_state)
+class board_state {
+public:
+    board_state() = default;
+    board_state(const board_state& other) { assign(other); }
+    board_state& operator=(const board_state& other) {
+        if (this != &other) assign(other);
+        return *this;
+    }
+
+    void assign(const board_state& other) {
+        if (bytes.size() < other.used) bytes.resize(other.used);
+        if (other.used > 0) std::memcpy(bytes.data(), other.bytes.data(), other.used);
+        used = other.used;
+    }
+
+    // Lays out a state for an n x m board with the given number of records, contents unset
+    void reset(int n, int m, size_t tank_count, size_t shell_count) {
+        board_state_header h{ n, m, static_cast<uint32_t>(tank_count), static_cast<uint32_t>(shell_count), 0 };
+        used = layers_offset(h) + 3 * static_cast<size_t>(n) * m;
+        if (bytes.size() < used) bytes.resize(used);
+        std::memcpy(bytes.data(), &h, sizeof(h));
+    }
+
+    bool empty() const { return used == 0; }
+    size_t size_bytes() const { return used; }
+
+    const board_state_header& header() const { return *reinterpret_cast<const board_state_header*>(bytes.data()); }
+    int n() const { return header().n; }
+    int m() const { return header().m; }
+    uint64_t hash() const { return header().hash; }
+    void set_hash(uint64_t h) { reinterpret_cast<board_state_header*>(bytes.data())->hash = h; }
+
+    std::span<tank_record> tanks() { return { at<tank_record>(tanks_offset()), header().tank_count }; }
+    std::span<const tank_record> tanks() const { return { at<const tank_record>(tanks_offset()), header().tank_count }; }
+    std::span<shell_record> shells() { return { at<shell_record>(shells_offset(header())), header().shell_count }; }
+    std::span<const shell_record> shells() const { return { at<const shell_record>(shells_offset(header())), header().shell_count }; }
+
+    // Per-cell layers, indexed y * n + x like game_board::cells
+    int8_t* wall_hp() { return at<int8_t>(layers_offset(header())); }
+    const int8_t* wall_hp() const { return at<const int8_t>(layers_offset(header())); }
+    uint8_t* mines() { return at<uint8_t>(layers_offset(header()) + cell_count()); }
+    const uint8_t* mines() const { return at<const uint8_t>(layers_offset(header()) + cell_count()); }
+    char* glyphs() { return at<char>(layers_offset(header()) + 2 * cell_count()); }
+    const char* glyphs() const { return at<const char>(layers_offset(header()) + 2 * cell_count()); }
+
+    const tank_record* find_tank(entity_id id) const {
+        for (const tank_record& r : tanks()) {
+            if (tank_entity_id(r.player_number, r.tank_number) == id) return &r;
+        }
+        return nullptr;
+    }
+
+    // What a SatelliteView reports for the cell: the first non-blank symbol on it, or ' '
+    char glyph_at(int x, int y) const { return glyphs()[y * n() + x]; }
+
+private:
+    std::vector<std::byte> bytes; // Only grows; operator new alignment covers every record
+    size_t used = 0;
+
+    static constexpr size_t align8(size_t offset) { return (offset + 7) & ~static_cast<size_t>(7); }
+    static constexpr size_t tanks_offset() { return align8(sizeof(board_state_header)); }
+    static size_t shells_offset(const board_state_header& h) {
+        return align8(tanks_offset() + h.tank_count * sizeof(tank_record));
+    }
+    static size_t layers_offset(const board_state_header& h) {
+        return align8(shells_offset(h) + h.shell_count * sizeof(shell_record));
+    }
+    size_t cell_count() const { return static_cast<size_t>(n()) * m(); }
+
+    template <typename T>
+    T* at(size_t offset) const {
+        return reinterpret_cast<T*>(const_cast<std::byte*>(bytes.data()) + offset);
+    }
+};
+
+// A board_state nobody may change any more, shared by reference count
+using board_snapshot = std::shared_ptr<const board_state>;
+
+// ==========
+// shared_board_state
+// ==========
+// Copy-on-write owner of a board_state. Readers take a board_snapshot and keep it as long as
+// they like; the owner refills the state in place while nobody else holds it, and moves on to
+// a fresh one when somebody does, so a snapshot never changes under its readers
+class shared_board_state {
+public:
+    bool empty() const { return !state || state->empty(); }
+    const board_state& read() const { return *state; }
+    board_snapshot share() const { return state; }
+
+    // The state to overwrite as a whole, its old contents are not carried over
+    board_state& rewrite() {
+        if (!state || state.use_count() > 1) state = std::make_shared<board_state>();
+        return *state;
+    }
+
+private:
+    std::shared_ptr<board_state> state;
+};
+
+#endif // BOARD_STATE_H
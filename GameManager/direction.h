@@ -0,0 +1,46 @@
+#ifndef DIRECTION_H
+#define DIRECTION_H
+
+#include <array>
+#include <cstdint>
+
+// ==========
+// direction
+// ==========
+// One of the eight headings as an index 0-7, every step up turns 45 degrees to the left
+// (y grows downwards, so 0 points down, 2 right, 4 up and 6 left). NO_DIRECTION is the
+// (0, 0) vector, used for shells whose heading could not be worked out
+using direction = uint8_t;
+
+constexpr int DIR_COUNT = 8;
+constexpr direction NO_DIRECTION = DIR_COUNT;
+
+constexpr std::array<int, DIR_COUNT + 1> DIR_DX = { 0, 1, 1, 1, 0, -1, -1, -1, 0 };
+constexpr std::array<int, DIR_COUNT + 1> DIR_DY = { 1, 1, 0, -1, -1, -1, 0, 1, 0 };
+constexpr std::array<const char*, DIR_COUNT + 1> DIR_GLYPH = { "↓", "↘", "→", "↗", "↑", "↖", "←", "↙", "" };
+
+// Index of the vector (dx, dy), both components in -1..1
+constexpr direction direction_of(int dx, int dy) {
+    constexpr direction by_delta[3][3] = {
+        { 5, 6, 7 },            // dx = -1, dy = -1..1
+        { 4, NO_DIRECTION, 0 }, // dx = 0
+        { 3, 2, 1 }             // dx = 1
+    };
+    return by_delta[dx + 1][dy + 1];
+}
+
+// Turns by 45 degree steps, positive to the left
+constexpr direction rotate_direction(direction d, int steps) {
+    if (d == NO_DIRECTION) return d;
+    return static_cast<direction>(((d + steps) % DIR_COUNT + DIR_COUNT) % DIR_COUNT);
+}
+
+constexpr bool direction_tables_agree() {
+    for (direction d = 0; d <= DIR_COUNT; d++) {
+        if (direction_of(DIR_DX[d], DIR_DY[d]) != d) return false;
+    }
+    return true;
+}
+static_assert(direction_tables_agree(), "DIR_DX/DIR_DY and direction_of disagree");
+
+#endif // DIRECTION_H
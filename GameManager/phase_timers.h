@@ -0,0 +1,286 @@
+#ifndef PHASE_TIMERS_H
+#define PHASE_TIMERS_H
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+
+// The parts of a GameManager round, in the order they run
+enum class game_phase : int {
+    shot_timers,  // Shot cool-down and out-of-shells bookkeeping
+    get_action,   // TankAlgorithm::getAction
+    battle_info,  // Satellite view refresh plus Player::updateTankWithBattleInfo
+    apply,        // tank::apply of the chosen actions
+    collisions,   // game_board::handle_cell_collisions
+    step,         // game_board::do_step
+    count
+};
+
+inline const char* phase_name(game_phase phase) {
+    switch (phase) {
+        case game_phase::shot_timers: return "shot_timers";
+        case game_phase::get_action: return "get_action";
+        case game_phase::battle_info: return "battle_info";
+        case game_phase::apply: return "apply";
+        case game_phase::collisions: return "collisions";
+        case game_phase::step: return "step";
+        default: return "unknown";
+    }
+}
+
+struct phase_totals {
+    static constexpr size_t N = static_cast<size_t>(game_phase::count);
+    std::array<uint64_t, N> ns{};
+    std::array<uint64_t, N> calls{};
+
+    void add(game_phase phase, uint64_t elapsed_ns) {
+        ns[static_cast<size_t>(phase)] += elapsed_ns;
+        calls[static_cast<size_t>(phase)]++;
+    }
+};
+
+// ==========
+// latency_histogram
+// ==========
+// Log-linear histogram of call latencies in nanoseconds: every power of two is split into 16
+// equal buckets, so a percentile read back is at most 1/16 above the true value. Fixed size and
+// allocation free, recording is a bit scan and an increment
+class latency_histogram {
+public:
+    static constexpr int SUB_BITS = 4;
+    static constexpr int SUB_BUCKETS = 1 << SUB_BITS;
+    static constexpr size_t BUCKETS = (64 - SUB_BITS + 1) * SUB_BUCKETS;
+
+    void record(uint64_t ns) {
+        counts[bucket(ns)]++;
+        total++;
+        max_ns = std::max(max_ns, ns);
+    }
+
+    void merge(const latency_histogram& other) {
+        for (size_t i = 0; i < BUCKETS; ++i) counts[i] += other.counts[i];
+        total += other.total;
+        max_ns = std::max(max_ns, other.max_ns);
+    }
+
+    uint64_t count() const { return total; }
+    uint64_t max() const { return max_ns; }
+
+    // Upper edge of the bucket holding the q-th quantile (0 < q <= 1), never above max()
+    uint64_t percentile(double q) const {
+        if (total == 0) return 0;
+        uint64_t rank = static_cast<uint64_t>(q * static_cast<double>(total) + 0.5);
+        rank = std::clamp<uint64_t>(rank, 1, total);
+        uint64_t seen = 0;
+        for (size_t i = 0; i < BUCKETS; ++i) {
+            seen += counts[i];
+            if (seen >= rank) return std::min(upper_edge(i), max_ns);
+        }
+        return max_ns;
+    }
+
+private:
+    std::array<uint64_t, BUCKETS> counts{};
+    uint64_t total = 0;
+    uint64_t max_ns = 0;
+
+    // Values below SUB_BUCKETS get a bucket each; above, the top SUB_BITS + 1 bits pick it
+    static size_t bucket(uint64_t ns) {
+        if (ns < SUB_BUCKETS) return static_cast<size_t>(ns);
+        int exponent = std::bit_width(ns) - 1;
+        uint64_t sub = (ns >> (exponent - SUB_BITS)) & (SUB_BUCKETS - 1);
+        return static_cast<size_t>(exponent - SUB_BITS + 1) * SUB_BUCKETS + sub;
+    }
+
+    static uint64_t upper_edge(size_t index) {
+        if (index < SUB_BUCKETS) return index;
+        int exponent = static_cast<int>(index / SUB_BUCKETS) + SUB_BITS - 1;
+        uint64_t sub = index % SUB_BUCKETS;
+        uint64_t width = uint64_t{1} << (exponent - SUB_BITS);
+        return (uint64_t{1} << exponent) + sub * width + (width - 1);
+    }
+};
+
+// Latency of one tank algorithm's calls into getAction and updateTankWithBattleInfo
+struct algorithm_latency {
+    latency_histogram get_action;
+    latency_histogram battle_info;
+    uint64_t overruns = 0;
+
+    void merge(const algorithm_latency& other) {
+        get_action.merge(other.get_action);
+        battle_info.merge(other.battle_info);
+        overruns += other.overruns;
+    }
+
+    // One JSON object: p50/p99/max per call and the budget overruns
+    void write_json(std::ostream& out) const {
+        out << "{ \"get_action\": ";
+        write_histogram(out, get_action);
+        out << ", \"battle_info\": ";
+        write_histogram(out, battle_info);
+        out << ", \"overruns\": " << overruns << " }";
+    }
+
+    static void write_histogram(std::ostream& out, const latency_histogram& h) {
+        out << "{ \"calls\": " << h.count() << ", \"p50_ns\": " << h.percentile(0.50)
+            << ", \"p99_ns\": " << h.percentile(0.99) << ", \"max_ns\": " << h.max() << " }";
+    }
+};
+
+// ==========
+// phase_timers
+// ==========
+// Wall time spent in each phase of one game, summed over the whole game and per player's tank
+// algorithm. Off unless the TANKS_PHASE_TIMERS environment variable names a directory (or a
+// call budget needs the clock); a disabled timer never reads the clock, so the round loop only
+// pays for a branch
+class phase_timers {
+public:
+    using clock = std::chrono::steady_clock;
+
+    // Directory the JSON sidecars go to, empty when timing is off
+    static std::string sidecar_dir_from_env() {
+        const char* dir = std::getenv("TANKS_PHASE_TIMERS");
+        return dir ? std::string(dir) : std::string();
+    }
+
+    void enable(bool on) { enabled = on; }
+    bool is_enabled() const { return enabled; }
+
+    void reset() {
+        game = {};
+        players = {};
+        latency = {};
+    }
+
+    clock::time_point start() const {
+        return enabled ? clock::now() : clock::time_point{};
+    }
+
+    uint64_t elapsed_since(clock::time_point started) const {
+        if (!enabled) return 0;
+        return static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - started).count());
+    }
+
+    // Closes a phase opened with start() and returns its length
+    uint64_t stop(game_phase phase, clock::time_point started) {
+        uint64_t elapsed = elapsed_since(started);
+        if (enabled) game.add(phase, elapsed);
+        return elapsed;
+    }
+
+    // Books one call into player 1 or 2's algorithm (get_action or battle_info)
+    void record_call(game_phase phase, int player, uint64_t elapsed_ns) {
+        if (!enabled || (player != 1 && player != 2)) return;
+        players[player - 1].add(phase, elapsed_ns);
+        algorithm_latency& l = latency[player - 1];
+        (phase == game_phase::get_action ? l.get_action : l.battle_info).record(elapsed_ns);
+    }
+
+    void record_overrun(int player) {
+        if (player == 1 || player == 2) latency[player - 1].overruns++;
+    }
+
+    const phase_totals& totals() const { return game; }
+    const phase_totals& player_totals(int player) const { return players[player - 1]; }
+    const algorithm_latency& player_latency(int player) const { return latency[player - 1]; }
+
+    void write_json(std::ostream& out, const std::string& map_name, const std::string& name1,
+                    const std::string& name2, size_t rounds) const {
+        out << "{\n  \"map\": \"" << escape(map_name) << "\",\n  \"rounds\": " << rounds
+            << ",\n  \"phases\": ";
+        write_phases(out, game, false);
+        out << ",\n  \"algorithms\": [\n";
+        for (int p = 1; p <= 2; ++p) {
+            out << "    { \"player\": " << p << ", \"name\": \"" << escape(p == 1 ? name1 : name2)
+                << "\", \"phases\": ";
+            write_phases(out, players[p - 1], true);
+            out << ", \"latency\": ";
+            latency[p - 1].write_json(out);
+            out << " }" << (p == 1 ? "," : "") << "\n";
+        }
+        out << "  ]\n}\n";
+    }
+
+private:
+    bool enabled = false;
+    phase_totals game;
+    std::array<phase_totals, 2> players;
+    std::array<algorithm_latency, 2> latency;
+
+    // Per-algorithm totals only list the phases spent inside the algorithm, and battle_info
+    // there is the player's call alone, without the satellite refresh
+    static void write_phases(std::ostream& out, const phase_totals& t, bool algorithm_only) {
+        out << "{";
+        bool first = true;
+        for (size_t i = 0; i < phase_totals::N; ++i) {
+            game_phase phase = static_cast<game_phase>(i);
+            if (algorithm_only && phase != game_phase::get_action && phase != game_phase::battle_info) continue;
+            out << (first ? " " : ", ") << "\"" << phase_name(phase) << "\": { \"calls\": " << t.calls[i]
+                << ", \"total_ns\": " << t.ns[i]
+                << ", \"mean_ns\": " << (t.calls[i] ? t.ns[i] / t.calls[i] : 0) << " }";
+            first = false;
+        }
+        out << " }";
+    }
+
+public:
+    static std::string escape(const std::string& s) {
+        std::string out;
+        for (char c : s) {
+            if (c == '"' || c == '\\') out += '\\';
+            if (static_cast<unsigned char>(c) < 0x20) continue;
+            out += c;
+        }
+        return out;
+    }
+};
+
+// ==========
+// latency_summary
+// ==========
+// Latencies per algorithm over every game a process has run, keyed by the name the simulator
+// passed for it (the algorithm's .so). Games on several threads add to it concurrently
+class latency_summary {
+public:
+    void add(const std::string& name, const algorithm_latency& latency) {
+        std::lock_guard<std::mutex> lock(mutex);
+        by_name[name].merge(latency);
+    }
+
+    // Rewrites the whole file; held under the lock so concurrent games never interleave in it
+    bool write_file(const std::string& path) const {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::ofstream out(path);
+        if (!out.is_open()) return false;
+        write_json(out);
+        return true;
+    }
+
+private:
+    mutable std::mutex mutex;
+    std::map<std::string, algorithm_latency> by_name;
+
+    void write_json(std::ostream& out) const {
+        out << "{\n  \"algorithms\": [\n";
+        size_t i = 0;
+        for (const auto& [name, latency] : by_name) {
+            out << "    { \"name\": \"" << phase_timers::escape(name) << "\", \"latency\": ";
+            latency.write_json(out);
+            out << " }" << (++i < by_name.size() ? "," : "") << "\n";
+        }
+        out << "  ]\n}\n";
+    }
+};
+
+#endif // PHASE_TIMERS_H
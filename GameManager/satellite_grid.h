@@ -0,0 +1,49 @@
+#ifndef SATELLITE_GRID_H
+#define SATELLITE_GRID_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+#include "SatelliteView.h"
+
+// ==========
+// satellite_grid
+// ==========
+// Optional bulk access for SatelliteView implementations that keep their cells in one
+// contiguous row-major buffer. It is a separate interface rather than a new virtual on
+// SatelliteView, so views compiled against the common header keep working unchanged
+class satellite_grid {
+public:
+    virtual ~satellite_grid() = default;
+
+    // grid_width() * grid_height() cells, cell (x, y) at y * grid_width() + x, or nullptr
+    virtual const char* grid_data() const = 0;
+    virtual size_t grid_width() const = 0;
+    virtual size_t grid_height() const = 0;
+};
+
+// Copies the width x height cells of view into out, row-major like satellite_grid. Views that
+// are a satellite_grid are copied a row at a time, any other view (and any cell outside the
+// grid) goes through getObjectAt
+inline void read_view_grid(const SatelliteView& view, size_t width, size_t height, std::vector<char>& out) {
+    out.resize(width * height);
+
+    size_t rows = 0, cols = 0;
+    const satellite_grid* grid = dynamic_cast<const satellite_grid*>(&view);
+    if (grid && grid->grid_data()) {
+        rows = std::min(height, grid->grid_height());
+        cols = std::min(width, grid->grid_width());
+        for (size_t y = 0; y < rows; ++y) {
+            std::memcpy(&out[y * width], grid->grid_data() + y * grid->grid_width(), cols);
+        }
+    }
+
+    for (size_t y = 0; y < height; ++y) {
+        for (size_t x = (y < rows ? cols : 0); x < width; ++x) {
+            out[y * width + x] = view.getObjectAt(x, y);
+        }
+    }
+}
+
+#endif // SATELLITE_GRID_H
@@ -53,8 +53,7 @@ GameResult GameManager1::run(
     }
 
 // Prepare cells
-std::vector<std::vector<cell>> arr;
-arr.reserve(map_width);
+board = std::make_unique<game_board>((int)map_width, (int)map_height);
 
 // Temporary storage for tanks + algos
 std::vector<std::shared_ptr<tank>> tempTanks;
@@ -62,17 +61,15 @@ std::vector<std::unique_ptr<TankAlgorithm>> tempAlgos;
 
 // Build grid from SatelliteView
 for (size_t i = 0; i < map_width; ++i) {
-    std::vector<cell> row;
-    row.reserve(map_height);
     for (size_t j = 0; j < map_height; ++j) {
-        row.emplace_back((int)i, (int)j);
+        cell& current = board->get_cell((int)i, (int)j);
         char c = map.getObjectAt(i, j);
 
         if (c == '#') {
-            row.back().add_Object(std::make_shared<wall>('#', &row.back()));
+            current.add_Object(std::make_shared<wall>('#', &current));
         }
         else if (c == '@') {
-            row.back().add_Object(std::make_shared<mine>('@', &row.back()));
+            current.add_Object(std::make_shared<mine>('@', &current));
         }
        else if (c == '1' || c == '2') {
     int player_idx = (c == '1' ? 0 : 1);   // 0 for Player1, 1 for Player2
@@ -82,8 +79,8 @@ for (size_t i = 0; i < map_width; ++i) {
 
     // Tanks use player_number = 1/2 (NOT 0/1), just like Task 2
     auto t = std::make_shared<tank>(c, player_idx + 1, tank_number,
-                                    directionx, 0, &row.back(), nullptr);
-    row.back().add_Object(t);
+                                    directionx, 0, &current, nullptr);
+    current.add_Object(t);
     tempTanks.push_back(t);
 
     // Algorithms always created with 0/1 indices (NOT 1/2)
@@ -104,15 +101,11 @@ for (size_t i = 0; i < map_width; ++i) {
 }
 
     }
-    arr.push_back(std::move(row));
 }
 
-// Create the board
-board = std::make_unique<game_board>((int)map_width, (int)map_height, std::move(arr));
-
 // Move tanks/algorithms into GameManager's storage
 for (auto& t : tempTanks) {
-    board->tanks.push_back(t);
+    board->add_tank(t);
 }
 for (auto& algo : tempAlgos) {
     tankAlgorithms.push_back(std::move(algo));
@@ -186,11 +179,13 @@ if (satview) {
         }
 
         for (tank* t : tanks_by_birth) {
-            if (t->shot_timer > 0) t->shot_timer--;
+            if (t->shot_timer > 0) {
+                t->shot_timer--;
+                board->rehash(t);
+            }
         }
 
         std::vector<ActionRequest> move_enums(tanks_by_birth.size(), ActionRequest::DoNothing);
-        std::vector<std::string> moves(tanks_by_birth.size());
         std::vector<bool> turn_success(tanks_by_birth.size(), false);
 
         // Ask each alive tank for move
@@ -199,15 +194,13 @@ if (satview) {
             if (t->alive) {
                 ActionRequest action = t->algo->getAction();
                 move_enums[i] = action;
-                moves[i] = actionToString(action);
                 turn_success[i] = true;
                 if (DEBUG_ENABLED) {
                     std::cout << "[DEBUG] GM1: Tank P" << t->player_number 
                               << " T" << t->tank_number 
-                              << " chose: " << moves[i] << "\n";
+                              << " chose: " << actionToString(action) << "\n";
                 }
             } else {
-                moves[i] = "killed";
                 move_enums[i] = ActionRequest::DoNothing;
                 if (DEBUG_ENABLED) {
                     std::cout << "[DEBUG] GM1: Tank P" << t->player_number 
@@ -220,7 +213,7 @@ if (satview) {
         for (size_t i = 0; i < tanks_by_birth.size(); ++i) {
             tank* t = tanks_by_birth[i];
             if (t->alive) {
-                if (moves[i] == "update") {
+                if (move_enums[i] == ActionRequest::GetBattleInfo) {
                     if (!satelliteCopyReady) {
                         static_cast<SatelliteViewImpl*>(satview.get())->updateCopy(*board);
                         satelliteCopyReady = true;
@@ -234,14 +227,13 @@ if (satview) {
                 }
                 continue;
                 }
-                bool ok = t->turn(board.get(), moves[i]);
+                bool ok = t->apply(board.get(), move_enums[i]);
                 if (!ok) {
-                    moves[i] += " (ignored)";
                     turn_success[i] = false;
                     if (DEBUG_ENABLED) {
                         std::cout << "[DEBUG] GM1: Tank P" << t->player_number 
                                   << " T" << t->tank_number 
-                                  << " invalid move: " << moves[i] << "\n";
+                                  << " invalid move: " << actionToString(move_enums[i]) << "\n";
                     }
                 }
             }
@@ -258,7 +250,6 @@ if (satview) {
         for (size_t i = 0; i < tanks_by_birth.size(); ++i) {
             tank* t = tanks_by_birth[i];
             if (recently_killed.count(t)) {
-                moves[i] += " (killed)";
                 killed_tanks.insert(t);
                 if (DEBUG_ENABLED) {
                     std::cout << "[DEBUG] GM1: Tank P" << t->player_number 
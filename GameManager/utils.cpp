@@ -25,11 +25,8 @@ std::pair<int, int> chebyshevDistanceToLine(const Vector2D& linePoint, const Vec
         newPoint.y = (newPoint.y + m) % m; // Wrap around the y-coordinate
 
         // Check if new point is blocked by a wall
-        if (board->get_cell(newPoint.x, newPoint.y).has_Object()) {
-            game_object* obj = board->get_cell(newPoint.x, newPoint.y).get_Object();
-            if (obj->get_symbol() == '#') {
-                break; // Stop if we hit a wall
-            }
+        if (board->has_wall(newPoint.x, newPoint.y)) {
+            break; // Stop if we hit a wall
         }
 
         // Calculate the distance from the point to the line
@@ -52,43 +49,12 @@ std::pair<int, int> chebyshevDistanceToLine(const Vector2D& linePoint, const Vec
 }
 
 
-const int DIR_COUNT = 8;
-const int dirX[DIR_COUNT] = {  0,  1,  1,  1,  0, -1, -1, -1 };
-const int dirY[DIR_COUNT] = {  1,  1,  0, -1, -1, -1,  0,  1 };
-
-std::pair<int, int> rotateDirection(int dirx, int diry, string direction) {
-    int index = -1;
-    for (int i = 0; i < DIR_COUNT; ++i) {
-        if (dirX[i] == dirx && dirY[i] == diry) {
-            index = i;
-            break;
-        }
-    }
-
-    if (index == -1) {
-        return {dirx, diry}; // If the direction is not found, return the original direction
-    }
-
-    if (direction == "left") {
-        index = (index + 1) % DIR_COUNT;
-    } else if (direction == "right") {
-        index = (index + DIR_COUNT - 1) % DIR_COUNT;
-    } else {
-        throw invalid_argument("Direction must be 'left' or 'right'.");
-    }
-
-    return {dirX[index], dirY[index]}; // Return the new direction vector
-}
-
-std::pair<int, int> rotate_4(int directionx, int directiony, std::string direction) {
-    pair<int, int> rotateOnce = rotateDirection(directionx, directiony, direction);
-    pair<int, int> rotateTwice = rotateDirection(rotateOnce.first, rotateOnce.second, direction);
-    return {rotateTwice.first, rotateTwice.second}; // Return the new direction after two rotations
+direction rotate_4(direction dir, rotation side) {
+    return rotate_direction(dir, side == rotation::left ? 2 : -2);
 }
 
-std::pair<int, int> rotate_8(int directionx, int directiony, std::string direction) {
-    pair<int, int> rotate = rotateDirection(directionx, directiony, direction);
-    return {rotate.first, rotate.second}; // Return the new direction after one rotation
+direction rotate_8(direction dir, rotation side) {
+    return rotate_direction(dir, side == rotation::left ? 1 : -1);
 }
 
 std::string join(const std::vector<std::string>& vec, const std::string& delim) {
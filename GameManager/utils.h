@@ -22,7 +22,7 @@ class wall;
 // Finds the closest Chebyshev distance between a point and a parametric line
 std::pair<int, int> chebyshevDistanceToLine(const Vector2D& linePoint, const Vector2D& lineDir, const Vector2D& point, game_board* board);
 std::string join(const std::vector<std::string>& vec, const std::string& delim);
-std::pair<int, int> rotate_4(int directionx, int directiony, std::string direction);
-std::pair<int, int> rotate_8(int directionx, int directiony, std::string direction);
+direction rotate_4(direction dir, rotation side);
+direction rotate_8(direction dir, rotation side);
 
 #endif // UTILS_H
@@ -5,6 +5,7 @@
 #include <algorithm>
 #include <filesystem>
 #include <thread>
+#include <functional>
 #include <mutex>
 #include <fstream>
 #include <sstream>
@@ -23,6 +24,8 @@
 #include "Board.h"
 #include "GameObject.h"
 #include "SatelliteViewImpl.h"
+#include "satellite_grid.h"
+#include "work_stealing_pool.h"
 
 namespace fs = std::filesystem;
 
@@ -104,17 +107,7 @@ LoadedMap buildMapFromFile(const std::string& filename, PlayerFactory& pf) {
     }
 
     // Build a temporary board
-    std::vector<std::vector<cell>> arr;
-    arr.reserve(cols);
-    for (int i = 0; i < cols; i++) {
-        std::vector<cell> col;
-        col.reserve(rows);
-        for (int j = 0; j < rows; j++) {
-            col.emplace_back(i, j);
-        }
-        arr.emplace_back(std::move(col));
-    }
-    auto board = std::make_unique<game_board>(cols, rows, std::move(arr));
+    auto board = std::make_unique<game_board>(cols, rows);
 
     if (DEBUG_MAP) {
         std::cout << "[DEBUG] Board created with dimensions "
@@ -249,6 +242,13 @@ void writeComparativeResults(const std::string& gmFolder,
     out << "algorithm1=" << algo1Name << "\n";
     out << "algorithm2=" << algo2Name << "\n\n";
 
+    // Final boards, read once each so grouping and writing work on plain rows
+    std::vector<std::vector<char>> finalBoards(results.size());
+    for (size_t i=0;i<results.size();i++) {
+        if (results[i].second.gameState)
+            read_view_grid(*results[i].second.gameState, width, height, finalBoards[i]);
+    }
+
     // group by identical results
     std::vector<bool> used(results.size(), false);
     for (size_t i=0;i<results.size();i++) {
@@ -265,13 +265,7 @@ void writeComparativeResults(const std::string& gmFolder,
                 r1.rounds==r2.rounds &&
                 r1.gameState && r2.gameState)
             {
-                bool identical=true;
-                for (size_t x=0;x<width && identical;x++)
-                    for (size_t y=0;y<height;y++)
-                        if (r1.gameState->getObjectAt(x,y)!=
-                            r2.gameState->getObjectAt(x,y)) {
-                            identical=false; break;
-                        }
+                bool identical = finalBoards[i]==finalBoards[j];
                 if (identical) {
                     sameGMs.push_back(results[j].first);
                     used[j]=true;
@@ -298,8 +292,7 @@ void writeComparativeResults(const std::string& gmFolder,
         // d) final board
         if (results[i].second.gameState) {
             for (size_t y=0;y<height;y++) {
-                for (size_t x=0;x<width;x++)
-                    out<<results[i].second.gameState->getObjectAt(x,y);
+                out.write(&finalBoards[i][y*width], width);
                 out<<"\n";
             }
         }
@@ -398,27 +391,38 @@ if (comparative) {
         return 1;
     }
 
-    std::mutex resultsMutex;
-    struct NamedResult { std::string gmName; GameResult result; };
-    std::vector<NamedResult> allResults;
-    std::vector<std::thread> threads;
-
-    size_t width=0,height=0;
-
-    auto worker = [&](const std::string& gmFile) {
-        std::string gmName = fs::path(gmFile).filename().string();
+    // --- load every GM up front, the registrar is not safe to use from the game threads ---
+    struct GameManagerEntry {
+        std::string file;
+        std::function<std::unique_ptr<AbstractGameManager>(bool)> factory;
+    };
+    std::vector<GameManagerEntry> gms;
+    for (auto& gmFile : gmFiles) {
         GameManagerRegistrar::get().clear();
         loadGameManagerSO(gmFile);
 
         auto& gmReg = GameManagerRegistrar::get();
         if (gmReg.empty()) {
             std::cerr << "[ERROR] No game managers registered for: " << gmFile << "\n";
-            return;
+            continue;
         }
+        gms.push_back({gmFile, gmReg.last()});
+    }
+
+    std::mutex resultsMutex;
+    struct NamedResult { std::string gmName; GameResult result; };
+    // One slot per GM, so the results keep the folder order whichever game finishes first
+    std::vector<std::unique_ptr<NamedResult>> resultSlots(gms.size());
+
+    size_t width=0,height=0;
+
+    auto worker = [&](size_t slot) {
+        const std::string& gmFile = gms[slot].file;
+        std::string gmName = fs::path(gmFile).filename().string();
 
         std::unique_ptr<AbstractGameManager> gm;
         try {
-            gm = gmReg.last()(verbose);
+            gm = gms[slot].factory(verbose);
             if (!gm) {
                 std::cerr << "[ERROR] GM factory returned null for: " << gmFile << "\n";
                 return;
@@ -438,7 +442,10 @@ if (comparative) {
         TankAlgorithmFactory tf2 = [&](int p, int t) { return algoEntry2.createTankAlgorithm(p, t); };
 
         LoadedMap map = buildMapFromFile(mapfile, pf);
-        width=map.width; height=map.height;
+        {
+            std::lock_guard<std::mutex> lk(resultsMutex);
+            width=map.width; height=map.height;
+        }
 
         GameResult res;
         try {
@@ -456,18 +463,22 @@ if (comparative) {
         }
 
         std::lock_guard<std::mutex> lk(resultsMutex);
-        allResults.push_back({gmName,std::move(res)});
+        resultSlots[slot] = std::make_unique<NamedResult>(NamedResult{gmName,std::move(res)});
     };
 
-    // --- thread batching ---
-    for (auto& gmFile : gmFiles) {
-        threads.emplace_back(worker, gmFile);
-        if (threads.size() >= numThreads) {
-            for (auto& t : threads) t.join();
-            threads.clear();
+    // --- run every GM on the pool ---
+    {
+        work_stealing_pool pool(numThreads);
+        for (size_t i = 0; i < gms.size(); i++) {
+            pool.submit([&worker, i] { worker(i); });
         }
+        pool.wait();
+    }
+
+    std::vector<NamedResult> allResults;
+    for (auto& slot : resultSlots) {
+        if (slot) allResults.push_back(std::move(*slot));
     }
-    for (auto& t : threads) t.join();
 
     // --- group identical results ---
     std::vector<bool> used(allResults.size(), false);
@@ -489,6 +500,13 @@ if (comparative) {
     out << "algorithm1=" << algo1Name << "\n";
     out << "algorithm2=" << algo2Name << "\n\n";
 
+    // Final boards, read once each so grouping and writing work on plain rows
+    std::vector<std::vector<char>> finalBoards(allResults.size());
+    for (size_t i=0;i<allResults.size();i++) {
+        if (allResults[i].result.gameState)
+            read_view_grid(*allResults[i].result.gameState, width, height, finalBoards[i]);
+    }
+
     for (size_t i=0;i<allResults.size();i++) {
         if (used[i]) continue;
         std::vector<std::string> sameGMs{allResults[i].gmName};
@@ -501,10 +519,7 @@ if (comparative) {
                               ri.reason==rj.reason &&
                               ri.rounds==rj.rounds);
             if (identical && ri.gameState && rj.gameState) {
-                for (size_t x=0;x<width && identical;x++)
-                    for (size_t y=0;y<height;y++)
-                        if (ri.gameState->getObjectAt(x,y)!=rj.gameState->getObjectAt(x,y))
-                            { identical=false; break; }
+                identical = finalBoards[i]==finalBoards[j];
             }
             if (identical) {
                 sameGMs.push_back(allResults[j].gmName);
@@ -531,8 +546,7 @@ if (comparative) {
         // d) final board
         if (ri.gameState) {
             for (size_t y=0;y<height;y++) {
-                for (size_t x=0;x<width;x++)
-                    out<<ri.gameState->getObjectAt(x,y);
+                out.write(&finalBoards[i][y*width], width);
                 out<<"\n";
             }
         }
@@ -570,7 +584,8 @@ if (competition) {
         std::cerr << "[ERROR] No game managers registered!\n";
         return 1;
     }
-    std::unique_ptr<AbstractGameManager> gm = gmReg.last()(verbose);
+    // Every game gets its own GM from this factory, a GM keeps per-game state while it runs
+    auto gmFactory = gmReg.last();
 
     // --- load algorithms ---
     std::vector<AlgorithmEntry> algs;
@@ -605,7 +620,6 @@ if (competition) {
     // --- scores ---
     std::map<std::string,int> scores;
     std::mutex scoreMutex;
-    std::vector<std::thread> threads;
 
     auto worker = [&](const std::string& mapFile,
                       const AlgorithmEntry& a1,
@@ -618,6 +632,12 @@ if (competition) {
         TankAlgorithmFactory tf1 = [&](int p,int t){ return a1.factories.createTankAlgorithm(p,t); };
         TankAlgorithmFactory tf2 = [&](int p,int t){ return a2.factories.createTankAlgorithm(p,t); };
 
+        std::unique_ptr<AbstractGameManager> gm = gmFactory(verbose);
+        if (!gm) {
+            std::cerr << "[ERROR] GM factory returned null for: " << mapFile << "\n";
+            return;
+        }
+
         LoadedMap map = buildMapFromFile(mapFile, pf);
         GameResult res = gm->run(map.width,map.height,map.view,mapFile,
                                  map.maxSteps,map.numShells,
@@ -630,7 +650,8 @@ if (competition) {
         else { scores[a1.file]+=1; scores[a2.file]+=1; }
     };
 
-    // --- run schedule ---
+    // --- run schedule on the pool ---
+    work_stealing_pool pool((size_t)std::max(1, numThreads));
     for (size_t k=0;k<maps.size();k++) {
         for (size_t i=0;i<N;i++) {
             size_t j = (i + 1 + k % (N-1)) % N;
@@ -638,18 +659,10 @@ if (competition) {
             // Avoid duplicate if N even and k==N/2 -1
             if (N%2==0 && k==(N/2 -1) && j==(i+N/2)%N) continue;
 
-            if (numThreads<=1) {
-                worker(maps[k], algs[i], algs[j]);
-            } else {
-                threads.emplace_back(worker,maps[k],algs[i],algs[j]);
-                if (threads.size()>= (size_t)numThreads) {
-                    for (auto& t:threads) t.join();
-                    threads.clear();
-                }
-            }
+            pool.submit([&worker, &maps, &algs, k, i, j] { worker(maps[k], algs[i], algs[j]); });
         }
     }
-    for (auto& t:threads) t.join();
+    pool.wait();
 
     // --- output file ---
     auto now = std::chrono::system_clock::now();
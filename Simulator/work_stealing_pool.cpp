@@ -0,0 +1,92 @@
+#include "work_stealing_pool.h"
+#include <algorithm>
+
+work_stealing_pool::work_stealing_pool(size_t thread_count) {
+    thread_count = std::max<size_t>(1, thread_count);
+    for (size_t i = 0; i < thread_count; i++) {
+        queues.push_back(std::make_unique<worker_queue>());
+    }
+    for (size_t i = 0; i < thread_count; i++) {
+        threads.emplace_back(&work_stealing_pool::worker_loop, this, i);
+    }
+}
+
+work_stealing_pool::~work_stealing_pool() {
+    {
+        std::lock_guard<std::mutex> lock(state_mtx);
+        stopping = true;
+    }
+    work_cv.notify_all();
+    for (auto& t : threads) {
+        t.join();
+    }
+}
+
+void work_stealing_pool::submit(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(state_mtx);
+        worker_queue& q = *queues[next_queue];
+        next_queue = (next_queue + 1) % queues.size();
+        {
+            std::lock_guard<std::mutex> queue_lock(q.mtx);
+            q.tasks.push_back(std::move(task));
+        }
+        queued++;
+        unfinished++;
+    }
+    work_cv.notify_one();
+}
+
+void work_stealing_pool::wait() {
+    std::unique_lock<std::mutex> lock(state_mtx);
+    idle_cv.wait(lock, [this] { return unfinished == 0; });
+    if (error) {
+        std::exception_ptr first = error;
+        error = nullptr;
+        std::rethrow_exception(first);
+    }
+}
+
+// Own queue first, oldest task first; then the newest task of the next non-empty queue
+bool work_stealing_pool::take_task(size_t index, std::function<void()>& task) {
+    for (size_t k = 0; k < queues.size(); k++) {
+        worker_queue& q = *queues[(index + k) % queues.size()];
+        std::lock_guard<std::mutex> lock(q.mtx);
+        if (q.tasks.empty()) continue;
+        if (k == 0) {
+            task = std::move(q.tasks.front());
+            q.tasks.pop_front();
+        } else {
+            task = std::move(q.tasks.back());
+            q.tasks.pop_back();
+        }
+        return true;
+    }
+    return false;
+}
+
+void work_stealing_pool::worker_loop(size_t index) {
+    while (true) {
+        std::function<void()> task;
+        if (take_task(index, task)) {
+            {
+                std::lock_guard<std::mutex> lock(state_mtx);
+                queued--;
+            }
+            std::exception_ptr caught;
+            try {
+                task();
+            } catch (...) {
+                caught = std::current_exception();
+            }
+            std::lock_guard<std::mutex> lock(state_mtx);
+            if (caught && !error) error = caught;
+            if (--unfinished == 0) idle_cv.notify_all();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(state_mtx);
+        work_cv.wait(lock, [this] { return stopping || queued > 0; });
+        if (stopping && queued == 0) return; // Stopping and nothing left to run
+    }
+}
@@ -0,0 +1,59 @@
+#ifndef WORK_STEALING_POOL_H
+#define WORK_STEALING_POOL_H
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// ==========
+// work_stealing_pool
+// ==========
+// Persistent threads for the simulator's games. Every worker owns a queue; submit() deals the
+// tasks out round-robin, a worker runs its own queue from the front and, once that is empty,
+// steals from the back of the others', so no thread idles while any game is still waiting.
+// Unlike a batch of threads joined together, one long game only ever holds up its own worker
+class work_stealing_pool {
+public:
+    explicit work_stealing_pool(size_t thread_count);
+    ~work_stealing_pool(); // Runs whatever is still queued, then joins the workers
+
+    work_stealing_pool(const work_stealing_pool&) = delete;
+    work_stealing_pool& operator=(const work_stealing_pool&) = delete;
+
+    void submit(std::function<void()> task);
+
+    // Blocks until every task submitted so far has finished, then rethrows the first exception
+    // any of them threw
+    void wait();
+
+    size_t size() const { return threads.size(); }
+
+private:
+    struct worker_queue {
+        std::mutex mtx;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    std::vector<std::unique_ptr<worker_queue>> queues;
+    std::vector<std::thread> threads;
+
+    // Lock order: state_mtx may be held while taking a worker_queue's mtx, never the reverse
+    std::mutex state_mtx;
+    std::condition_variable work_cv; // Signalled when tasks are queued or the pool stops
+    std::condition_variable idle_cv; // Signalled when the last unfinished task finishes
+    size_t queued = 0;               // Tasks sitting in a queue
+    size_t unfinished = 0;           // Tasks submitted and not finished yet
+    size_t next_queue = 0;
+    bool stopping = false;
+    std::exception_ptr error;
+
+    void worker_loop(size_t index);
+    bool take_task(size_t index, std::function<void()>& task);
+};
+
+#endif // WORK_STEALING_POOL_H